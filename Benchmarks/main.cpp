@@ -0,0 +1,413 @@
+#include "lve_obj_stream_reader.hpp"
+#include "lve_obj_tokenizer.hpp"
+#include "lve_utils.hpp"
+#include "lve_vertex_welder.hpp"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+//the engine no longer calls tinyobj, it is only compiled in here as the baseline
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using lve::LveModel;
+using lve::LveObjStreamReader;
+using lve::LveObjTokenizer;
+using lve::LveVertexWelder;
+
+// CPU micro-benchmarks of the model import paths. Each one first checks that its result matches the
+// straightforward implementation it replaced, then prints the best of a few timed runs
+
+//the hash LveModel used before LveVertexWelder, kept here as the baseline
+namespace std
+{
+	template <>
+	struct hash<LveModel::Vertex>
+	{
+		size_t operator()(LveModel::Vertex const& vertex) const
+		{
+			size_t seed = 0;
+			lve::hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
+			return seed;
+		}
+	};
+}
+
+static constexpr uint32_t RUNS = 3;
+
+template <typename Function>
+static double bestOf(uint32_t runs, Function&& function)
+{
+	double bestSeconds = INFINITY;
+	for (uint32_t run = 0; run < runs; run++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		function();
+		bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+	return bestSeconds;
+}
+
+// A heightfield grid laid out the way tinyobj hands a mesh over: a table of distinct vertices and one reference
+// into it per triangle corner, so every interior vertex shows up six times in the corner stream
+struct SyntheticMesh
+{
+	std::vector<LveModel::Vertex> gridVertices;
+	std::vector<uint32_t> corners;
+};
+
+static SyntheticMesh makeGrid(uint32_t triangleCount)
+{
+	uint32_t quads = static_cast<uint32_t>(std::ceil(std::sqrt(triangleCount / 2.0)));
+	uint32_t side = quads + 1;
+
+	SyntheticMesh mesh;
+	mesh.gridVertices.resize(static_cast<size_t>(side) * side);
+	for (uint32_t y = 0; y < side; y++)
+	{
+		for (uint32_t x = 0; x < side; x++)
+		{
+			float u = static_cast<float>(x) / quads;
+			float v = static_cast<float>(y) / quads;
+			float height = std::sin(u * 40.f) * std::cos(v * 40.f) * .05f;
+
+			LveModel::Vertex& vertex = mesh.gridVertices[static_cast<size_t>(y) * side + x];
+			vertex.position = { u, height, v };
+			vertex.color = { u, v, 1.f };
+			vertex.normal = glm::normalize(glm::vec3{ -std::cos(u * 40.f) * std::cos(v * 40.f) * 2.f, 1.f, std::sin(u * 40.f) * std::sin(v * 40.f) * 2.f });
+			vertex.uv = { u, v };
+		}
+	}
+
+	mesh.corners.reserve(static_cast<size_t>(quads) * quads * 6);
+	for (uint32_t y = 0; y < quads; y++)
+	{
+		for (uint32_t x = 0; x < quads; x++)
+		{
+			uint32_t corner = y * side + x;
+			const uint32_t quad[6] = { corner, corner + side, corner + 1, corner + 1, corner + side, corner + side + 1 };
+			mesh.corners.insert(mesh.corners.end(), quad, quad + 6);
+		}
+	}
+	return mesh;
+}
+
+struct WeldResult
+{
+	std::vector<LveModel::Vertex> vertices;
+	std::vector<uint32_t> indices;
+};
+
+//the loop LveModel::Builder::loadModel ran before LveVertexWelder
+static WeldResult weldWithUnorderedMap(const SyntheticMesh& mesh)
+{
+	WeldResult result;
+	result.indices.reserve(mesh.corners.size());
+
+	std::unordered_map<LveModel::Vertex, uint32_t> uniqueVertices{};
+	for (uint32_t corner : mesh.corners)
+	{
+		const LveModel::Vertex& vertex = mesh.gridVertices[corner];
+		if (uniqueVertices.count(vertex) == 0)
+		{
+			uniqueVertices[vertex] = static_cast<uint32_t>(result.vertices.size());
+			result.vertices.push_back(vertex);
+		}
+		result.indices.push_back(uniqueVertices[vertex]);
+	}
+	return result;
+}
+
+static WeldResult weldWithWelder(const SyntheticMesh& mesh)
+{
+	WeldResult result;
+	result.indices.reserve(mesh.corners.size());
+
+	LveVertexWelder welder{ mesh.corners.size() };
+	for (uint32_t corner : mesh.corners)
+	{
+		result.indices.push_back(welder.weld(mesh.gridVertices[corner], result.vertices));
+	}
+	return result;
+}
+
+static void benchWeld(uint32_t triangleCount)
+{
+	SyntheticMesh mesh = makeGrid(triangleCount);
+
+	WeldResult expected = weldWithUnorderedMap(mesh);
+	WeldResult welded = weldWithWelder(mesh);
+	if (welded.indices != expected.indices || welded.vertices.size() != expected.vertices.size() ||
+		!std::equal(welded.vertices.begin(), welded.vertices.end(), expected.vertices.begin()))
+	{
+		throw std::runtime_error("LveVertexWelder result differs from std::unordered_map!");
+	}
+
+	double mapSeconds = bestOf(RUNS, [&]() { weldWithUnorderedMap(mesh); });
+	double welderSeconds = bestOf(RUNS, [&]() { weldWithWelder(mesh); });
+	double megaCorners = mesh.corners.size() / 1e6;
+
+	std::cout << "weld: " << mesh.corners.size() / 3 << " triangles, " << expected.vertices.size() << " unique vertices\n";
+	std::cout << "                        ms   Mcorners/s\n";
+	char line[128];
+	std::snprintf(line, sizeof(line), "std::unordered_map %7.1f %12.1f\n", mapSeconds * 1000.0, megaCorners / mapSeconds);
+	std::cout << line;
+	std::snprintf(line, sizeof(line), "LveVertexWelder    %7.1f %12.1f\n", welderSeconds * 1000.0, megaCorners / welderSeconds);
+	std::cout << line;
+	std::snprintf(line, sizeof(line), "speedup %.2fx\n", mapSeconds / welderSeconds);
+	std::cout << line;
+}
+
+//the grid written out the way an exporter would, every corner referencing a position, texcoord and normal
+static std::string writeSyntheticObj(uint32_t triangleCount)
+{
+	SyntheticMesh mesh = makeGrid(triangleCount);
+	std::string path = (std::filesystem::temp_directory_path() / "lve_benchmark.obj").string();
+
+	std::ofstream file{ path, std::ios::binary };
+	if (!file.is_open())
+	{
+		throw std::runtime_error("failed to create file: " + path);
+	}
+
+	char line[256];
+	for (const LveModel::Vertex& vertex : mesh.gridVertices)
+	{
+		int length = std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n",
+			vertex.position.x, vertex.position.y, vertex.position.z, vertex.uv.x, vertex.uv.y, vertex.normal.x, vertex.normal.y, vertex.normal.z);
+		file.write(line, length);
+	}
+	for (size_t i = 0; i < mesh.corners.size(); i += 3)
+	{
+		uint32_t a = mesh.corners[i] + 1, b = mesh.corners[i + 1] + 1, c = mesh.corners[i + 2] + 1;
+		int length = std::snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+		file.write(line, length);
+	}
+	return path;
+}
+
+static std::vector<char> readFile(const std::string& path)
+{
+	std::ifstream file{ path, std::ios::binary | std::ios::ate };
+	if (!file.is_open())
+	{
+		throw std::runtime_error("failed to open file: " + path);
+	}
+
+	std::vector<char> text(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(text.data(), static_cast<std::streamsize>(text.size()));
+	return text;
+}
+
+template <typename FindLineEnd>
+static size_t countLines(const std::vector<char>& text, FindLineEnd findLineEnd)
+{
+	size_t lines = 0;
+	const char* cursor = text.data();
+	const char* end = text.data() + text.size();
+	while (cursor < end)
+	{
+		const char* lineEnd = findLineEnd(cursor, end);
+		cursor = lineEnd < end ? lineEnd + 1 : end;
+		lines++;
+	}
+	return lines;
+}
+
+//every number on the v, vt and vn lines, in file order
+template <typename ParseFloat>
+static void parseAttributeFloats(const std::vector<char>& text, ParseFloat parseFloat, std::vector<float>& values)
+{
+	values.clear();
+	const char* cursor = text.data();
+	const char* end = text.data() + text.size();
+	while (cursor < end)
+	{
+		const char* lineEnd = LveObjTokenizer::findLineEnd(cursor, end);
+		if (lineEnd - cursor > 2 && cursor[0] == 'v')
+		{
+			const char* number = cursor + (cursor[1] == ' ' ? 2 : 3);
+			float value;
+			while ((number = parseFloat(number, lineEnd, value)) != nullptr)
+			{
+				values.push_back(value);
+			}
+		}
+		cursor = lineEnd < end ? lineEnd + 1 : end;
+	}
+}
+
+static size_t countDifferentBits(const std::vector<float>& a, const std::vector<float>& b)
+{
+	size_t different = a.size() > b.size() ? a.size() - b.size() : b.size() - a.size();
+	for (size_t i = 0; i < std::min(a.size(), b.size()); i++)
+	{
+		different += std::memcmp(&a[i], &b[i], sizeof(float)) != 0;
+	}
+	return different;
+}
+
+//distance in representable floats, +0 and -0 are the same point. Sizes have to match, see countDifferentBits
+static uint64_t maxUlpDistance(const std::vector<float>& a, const std::vector<float>& b)
+{
+	auto ordered = [](float value)
+		{
+			int64_t bits = std::bit_cast<int32_t>(value);
+			return bits < 0 ? -(bits & 0x7FFFFFFF) : bits;
+		};
+
+	uint64_t maxDistance = 0;
+	for (size_t i = 0; i < std::min(a.size(), b.size()); i++)
+	{
+		int64_t distance = ordered(a[i]) - ordered(b[i]);
+		maxDistance = std::max(maxDistance, static_cast<uint64_t>(distance < 0 ? -distance : distance));
+	}
+	return maxDistance;
+}
+
+static void printThroughput(const char* name, double seconds, double megabytes)
+{
+	char line[128];
+	std::snprintf(line, sizeof(line), "%-32s %8.1f %10.1f\n", name, seconds * 1000.0, megabytes / seconds);
+	std::cout << line;
+}
+
+static void benchObj(const std::string& path)
+{
+	std::vector<char> text = readFile(path);
+	double megabytes = text.size() / 1e6;
+
+	//the fast float path has to agree with from_chars on every number before its time means anything
+	std::vector<float> scalarValues, values;
+	parseAttributeFloats(text, LveObjTokenizer::parseFloatScalar, scalarValues);
+	parseAttributeFloats(text, LveObjTokenizer::parseFloat, values);
+	if (countDifferentBits(scalarValues, values) != 0)
+	{
+		throw std::runtime_error("LveObjTokenizer::parseFloat differs from parseFloatScalar!");
+	}
+
+	size_t lines = 0;
+	double scalarSplitSeconds = bestOf(RUNS, [&]() { lines = countLines(text, LveObjTokenizer::findLineEndScalar); });
+	double splitSeconds = bestOf(RUNS, [&]() { lines = countLines(text, LveObjTokenizer::findLineEnd); });
+	double scalarParseSeconds = bestOf(RUNS, [&]() { parseAttributeFloats(text, LveObjTokenizer::parseFloatScalar, scalarValues); });
+	double parseSeconds = bestOf(RUNS, [&]() { parseAttributeFloats(text, LveObjTokenizer::parseFloat, values); });
+
+	tinyobj::attrib_t tinyobjAttrib;
+	std::vector<tinyobj::shape_t> shapes;
+	double tinyobjSeconds = bestOf(RUNS, [&]()
+		{
+			std::vector<tinyobj::material_t> materials;
+			std::string warn, err;
+			shapes.clear();
+			if (!tinyobj::LoadObj(&tinyobjAttrib, &shapes, &materials, &warn, &err, path.c_str()))
+			{
+				throw std::runtime_error(warn + err);
+			}
+		});
+
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::index_t> corners;
+	double readerSeconds = bestOf(RUNS, [&]() { LveObjStreamReader::readCorners(path, attrib, corners); });
+
+	std::cout << "obj: " << path << ", " << static_cast<size_t>(megabytes) << " MB, " << lines << " lines, " << values.size() << " attribute values\n";
+	std::cout << "                                       ms       MB/s\n";
+	printThroughput("findLineEndScalar", scalarSplitSeconds, megabytes);
+	printThroughput("findLineEnd", splitSeconds, megabytes);
+	printThroughput("parseFloatScalar (v/vt/vn lines)", scalarParseSeconds, megabytes);
+	printThroughput("parseFloat (v/vt/vn lines)", parseSeconds, megabytes);
+	printThroughput("tinyobj::LoadObj", tinyobjSeconds, megabytes);
+	printThroughput("LveObjStreamReader::readCorners", readerSeconds, megabytes);
+
+	//same check as objCornersMatchTinyobj in Tests: identical corners, numbers at most one ulp apart because
+	//tinyobj's own float parser isn't correctly rounded
+	std::vector<tinyobj::index_t> tinyobjCorners;
+	for (const tinyobj::shape_t& shape : shapes)
+	{
+		tinyobjCorners.insert(tinyobjCorners.end(), shape.mesh.indices.begin(), shape.mesh.indices.end());
+	}
+	bool sameCorners = tinyobjCorners.size() == corners.size() && std::equal(corners.begin(), corners.end(), tinyobjCorners.begin(),
+		[](const tinyobj::index_t& a, const tinyobj::index_t& b)
+		{
+			return a.vertex_index == b.vertex_index && a.normal_index == b.normal_index && a.texcoord_index == b.texcoord_index;
+		});
+	if (!sameCorners)
+	{
+		throw std::runtime_error("LveObjStreamReader::readCorners differs from tinyobj::LoadObj in its corners!");
+	}
+	bool sameSizes = attrib.vertices.size() == tinyobjAttrib.vertices.size() && attrib.normals.size() == tinyobjAttrib.normals.size() &&
+		attrib.texcoords.size() == tinyobjAttrib.texcoords.size();
+	uint64_t maxDistance = std::max({ maxUlpDistance(attrib.vertices, tinyobjAttrib.vertices),
+		maxUlpDistance(attrib.normals, tinyobjAttrib.normals), maxUlpDistance(attrib.texcoords, tinyobjAttrib.texcoords) });
+	if (!sameSizes || maxDistance > 1)
+	{
+		throw std::runtime_error("LveObjStreamReader::readCorners differs from tinyobj::LoadObj by more than an ulp!");
+	}
+
+	size_t differentValues = countDifferentBits(attrib.vertices, tinyobjAttrib.vertices) +
+		countDifferentBits(attrib.normals, tinyobjAttrib.normals) + countDifferentBits(attrib.texcoords, tinyobjAttrib.texcoords);
+	std::cout << "against tinyobj: corners identical, " << differentValues << " of " << values.size() << " values one ulp apart\n";
+}
+
+static void printUsage()
+{
+	std::cout <<
+		"usage: Benchmarks weld [triangles]\n"
+		"       Benchmarks obj [file.obj]\n"
+		"  weld  welds a synthetic grid (5M triangles by default) with LveVertexWelder and std::unordered_map\n"
+		"  obj   OBJ parsing throughput of LveObjTokenizer and LveObjStreamReader against tinyobj, on the given file or\n"
+		"        a synthetic 2M triangle grid\n";
+}
+
+int main(int argc, char** argv)
+{
+	std::string benchmark = argc > 1 ? argv[1] : "";
+
+	try
+	{
+		if (benchmark == "weld")
+		{
+			benchWeld(argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 5000000);
+		}
+		else if (benchmark == "obj")
+		{
+			if (argc > 2)
+			{
+				benchObj(argv[2]);
+			}
+			else
+			{
+				std::string path = writeSyntheticObj(2000000);
+				benchObj(path);
+				std::filesystem::remove(path);
+			}
+		}
+		else
+		{
+			printUsage();
+			return EXIT_FAILURE;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,375 @@
+#include "lve_test.hpp"
+#include "lve_allocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace lve;
+
+using Allocation = LveAllocator::Allocation;
+using ResourceKind = LveAllocator::ResourceKind;
+
+//the made up memory table, laid out like a discrete GPU: device local VRAM, plain and cached system memory, and the
+//small host visible window into VRAM
+static constexpr uint32_t DEVICE_LOCAL_TYPE = 0;
+static constexpr uint32_t HOST_VISIBLE_TYPE = 1;
+static constexpr uint32_t BAR_TYPE = 2;
+static constexpr uint32_t HOST_CACHED_TYPE = 3;
+static constexpr uint32_t ALL_TYPES = 0xF;
+
+static constexpr VkMemoryPropertyFlags HOST_MEMORY = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+static VkPhysicalDeviceMemoryProperties makeMemoryProperties()
+{
+	VkPhysicalDeviceMemoryProperties properties{};
+	properties.memoryHeapCount = 3;
+	properties.memoryHeaps[0] = { 8ull << 30, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+	properties.memoryHeaps[1] = { 16ull << 30, 0 };
+	properties.memoryHeaps[2] = { 256ull << 20, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+
+	properties.memoryTypeCount = 4;
+	properties.memoryTypes[DEVICE_LOCAL_TYPE] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+	properties.memoryTypes[HOST_VISIBLE_TYPE] = { HOST_MEMORY, 1 };
+	properties.memoryTypes[BAR_TYPE] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | HOST_MEMORY, 2 };
+	properties.memoryTypes[HOST_CACHED_TYPE] = { HOST_MEMORY | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 1 };
+	return properties;
+}
+
+// LveAllocator against the table above. Device memory handles are counters, host visible memory is backed by real
+// host allocations so mapped pointers can be written through
+class MockAllocator : public LveAllocator
+{
+public:
+	MockAllocator(VkDeviceSize bufferImageGranularity = 1)
+		: LveAllocator{ VK_NULL_HANDLE, makeMemoryProperties(), bufferImageGranularity } {}
+
+	//device allocations that were never freed
+	size_t liveMemoryCount() const { return live.size(); }
+	uint32_t allocateCalls = 0;
+
+	uint32_t failingTypes = 0;	//bit per memory type that reports out of device memory
+	bool failMapping = false;
+
+protected:
+	VkResult allocateMemory(uint32_t memoryTypeIndex, VkDeviceSize size, VkDeviceMemory& memory) override
+	{
+		allocateCalls++;
+		if (failingTypes & (1u << memoryTypeIndex))
+		{
+			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+		}
+
+		memory = VkDeviceMemory(static_cast<uintptr_t>(++lastHandle));
+		live[memory] = size;
+		return VK_SUCCESS;
+	}
+
+	void freeMemory(VkDeviceMemory memory) override
+	{
+		LVE_CHECK(live.erase(memory) == 1);
+		hostMemory.erase(memory);
+	}
+
+	void* mapMemory(VkDeviceMemory memory, VkDeviceSize size) override
+	{
+		LVE_CHECK(size == VK_WHOLE_SIZE && live.count(memory) == 1);
+		if (failMapping)
+		{
+			throw std::runtime_error("failed to map device memory!");
+		}
+
+		auto& backing = hostMemory[memory];
+		backing = std::make_unique_for_overwrite<char[]>(live[memory]);
+		return backing.get();
+	}
+
+private:
+	uint64_t lastHandle = 0;
+	std::map<VkDeviceMemory, VkDeviceSize> live;
+	std::map<VkDeviceMemory, std::unique_ptr<char[]>> hostMemory;
+};
+
+static VkMemoryRequirements makeRequirements(VkDeviceSize size, VkDeviceSize alignment = 1, uint32_t memoryTypeBits = ALL_TYPES)
+{
+	return VkMemoryRequirements{ size, alignment, memoryTypeBits };
+}
+
+static bool overlaps(const Allocation& a, const Allocation& b)
+{
+	return a.memory == b.memory && a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+}
+
+LVE_TEST(buddySplitsAndMergesBlocks)
+{
+	LveBuddyAllocator buddy{ 1024, 64 };
+	VkDeviceSize offset, reserved;
+
+	//the first request splits 1024 down to 64, leaving free halves of 64, 128, 256 and 512 behind it
+	LVE_CHECK(buddy.allocate(64, 1, offset, reserved) && offset == 0 && reserved == 64);
+	LVE_CHECK(buddy.allocate(50, 1, offset, reserved) && offset == 64 && reserved == 64);
+	LVE_CHECK(buddy.allocate(200, 1, offset, reserved) && offset == 256 && reserved == 256);
+	LVE_CHECK(buddy.allocate(512, 1, offset, reserved) && offset == 512 && reserved == 512);
+	LVE_CHECK(buddy.getBytesUsed() == 896);
+
+	//only the 128 at 128 is left
+	LVE_CHECK(!buddy.allocate(256, 1, offset, reserved));
+	LVE_CHECK(!buddy.allocate(2048, 1, offset, reserved));
+
+	//freeing both 64s merges them with the free 128 into the 256 at 0
+	buddy.free(0, 64);
+	buddy.free(64, 64);
+	LVE_CHECK(buddy.allocate(256, 1, offset, reserved) && offset == 0 && reserved == 256);
+	buddy.free(0, 256);
+
+	//everything merges back into the whole range
+	buddy.free(512, 512);
+	buddy.free(256, 256);
+	LVE_CHECK(buddy.isEmpty());
+	LVE_CHECK(buddy.allocate(1024, 1, offset, reserved) && offset == 0 && reserved == 1024);
+}
+
+LVE_TEST(buddyAlignsBlocksToTheirSize)
+{
+	LveBuddyAllocator buddy{ 1 << 20, 256 };
+	VkDeviceSize offset, reserved;
+
+	LVE_CHECK(buddy.allocate(300, 1, offset, reserved) && reserved == 512);
+
+	//a small request with a big alignment reserves a block of the alignment's size
+	LVE_CHECK(buddy.allocate(256, 4096, offset, reserved) && reserved == 4096 && offset % 4096 == 0);
+	LVE_CHECK(buddy.allocate(1000, 64, offset, reserved) && reserved == 1024 && offset % 1024 == 0);
+}
+
+LVE_TEST(allocationsAreAlignedAndDisjoint)
+{
+	MockAllocator allocator;
+	std::mt19937 random{ 11 };
+	std::vector<Allocation> allocations;
+
+	for (uint32_t i = 0; i < 4000; i++)
+	{
+		if (allocations.empty() || random() % 3 != 0)
+		{
+			VkMemoryRequirements requirements = makeRequirements(1 + random() % (1u << (random() % 22)), 1ull << (random() % 13));
+			VkMemoryPropertyFlags properties = random() % 2 ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT : HOST_MEMORY;
+			Allocation allocation = allocator.allocate(requirements, properties, ResourceKind::Linear);
+
+			LVE_CHECK(allocation.isValid());
+			LVE_CHECK(allocation.offset % requirements.alignment == 0);
+			LVE_CHECK(allocation.size >= requirements.size);
+			LVE_CHECK((allocation.propertyFlags & properties) == properties);
+			LVE_CHECK((allocation.mapped != nullptr) == ((properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0));
+			for (const Allocation& other : allocations)
+			{
+				LVE_CHECK(!overlaps(allocation, other));
+			}
+			allocations.push_back(allocation);
+		}
+		else
+		{
+			size_t index = random() % allocations.size();
+			allocator.free(allocations[index]);
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+
+	LveAllocator::Stats stats = allocator.getStats();
+	LVE_CHECK(stats.allocations == allocations.size());
+
+	for (Allocation& allocation : allocations)
+	{
+		allocator.free(allocation);
+	}
+	stats = allocator.getStats();
+	LVE_CHECK(stats.allocations == 0 && stats.bytesUsed == 0 && stats.dedicatedAllocations == 0);
+	//one empty block per memory type stays around
+	LVE_CHECK(stats.blocks <= 2 && allocator.liveMemoryCount() == stats.blocks);
+}
+
+LVE_TEST(allocationsShareBlocks)
+{
+	MockAllocator allocator;
+	Allocation first = allocator.allocate(makeRequirements(1000), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Linear);
+	Allocation second = allocator.allocate(makeRequirements(1000), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Linear);
+
+	LVE_CHECK(first.memory == second.memory && first.offset != second.offset);
+	LVE_CHECK(allocator.allocateCalls == 1);
+
+	allocator.free(first);
+	allocator.free(second);
+	LVE_CHECK(!first.isValid() && !second.isValid());
+}
+
+LVE_TEST(bufferImageGranularitySeparatesBuffersAndImages)
+{
+	//a page bigger than the smallest reservation, buffers and optimal images must not share blocks
+	{
+		MockAllocator allocator{ 4096 };
+		Allocation buffer = allocator.allocate(makeRequirements(1000), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Linear);
+		Allocation image = allocator.allocate(makeRequirements(1000), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Optimal);
+		Allocation otherImage = allocator.allocate(makeRequirements(1000), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Optimal);
+
+		LVE_CHECK(buffer.memory != image.memory);
+		LVE_CHECK(image.memory == otherImage.memory);
+		LVE_CHECK(allocator.getStats().blocks == 2);
+
+		allocator.free(buffer);
+		allocator.free(image);
+		allocator.free(otherImage);
+	}
+
+	//reservations already start and end on MIN_ALLOCATION_SIZE, so a smaller page lets them share
+	{
+		MockAllocator allocator{ LveAllocator::MIN_ALLOCATION_SIZE };
+		Allocation buffer = allocator.allocate(makeRequirements(1000), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Linear);
+		Allocation image = allocator.allocate(makeRequirements(1000), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Optimal);
+
+		LVE_CHECK(buffer.memory == image.memory);
+		LVE_CHECK(buffer.offset % LveAllocator::MIN_ALLOCATION_SIZE == 0 && image.offset % LveAllocator::MIN_ALLOCATION_SIZE == 0);
+		LVE_CHECK(allocator.getStats().blocks == 1);
+
+		allocator.free(buffer);
+		allocator.free(image);
+	}
+}
+
+LVE_TEST(largeRequestsGetDedicatedAllocations)
+{
+	MockAllocator allocator;
+
+	//more than half of a 64 MB device local block
+	VkDeviceSize size = 40ull << 20;
+	Allocation dedicated = allocator.allocate(makeRequirements(size), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Linear);
+	LVE_CHECK(dedicated.offset == 0 && dedicated.size == size);
+	LVE_CHECK(allocator.getStats().dedicatedAllocations == 1 && allocator.getStats().blocks == 0);
+
+	//the 256 MB heap gets 32 MB blocks, so 20 MB is already dedicated there, and it is mapped
+	Allocation bar = allocator.allocate(makeRequirements(20ull << 20), HOST_MEMORY, ResourceKind::Linear,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	LVE_CHECK(bar.memoryTypeIndex == BAR_TYPE && bar.mapped != nullptr);
+	LVE_CHECK(allocator.getStats().dedicatedAllocations == 2);
+
+	std::vector<LveAllocator::HeapStats> heaps = allocator.getHeapStats();
+	LVE_CHECK(heaps[0].bytesReserved == size && heaps[2].bytesReserved == (20ull << 20));
+
+	allocator.free(dedicated);
+	allocator.free(bar);
+	LVE_CHECK(allocator.liveMemoryCount() == 0);
+	LVE_CHECK(allocator.getStats().dedicatedAllocations == 0);
+}
+
+LVE_TEST(preferredTypeFallsBackToRequiredFlags)
+{
+	MockAllocator allocator;
+
+	//unasked flags count against a type, preferred ones for it
+	LVE_CHECK(allocator.findMemoryType(ALL_TYPES, HOST_MEMORY) == HOST_VISIBLE_TYPE);
+	LVE_CHECK(allocator.findMemoryType(ALL_TYPES, HOST_MEMORY, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == BAR_TYPE);
+	LVE_CHECK(allocator.findMemoryType(ALL_TYPES, HOST_MEMORY, VK_MEMORY_PROPERTY_HOST_CACHED_BIT) == HOST_CACHED_TYPE);
+	LVE_CHECK(allocator.findMemoryType(ALL_TYPES, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == DEVICE_LOCAL_TYPE);
+	LVE_CHECK(allocator.findMemoryType(1u << BAR_TYPE, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == BAR_TYPE);
+
+	//a full BAR heap leaves the buffer in plain host memory
+	allocator.failingTypes = 1u << BAR_TYPE;
+	Allocation allocation = allocator.allocate(makeRequirements(4096), HOST_MEMORY, ResourceKind::Linear, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	LVE_CHECK(allocation.memoryTypeIndex == HOST_VISIBLE_TYPE && allocation.mapped != nullptr);
+	allocator.free(allocation);
+
+	//nothing to fall back to
+	bool threw = false;
+	try
+	{
+		allocator.allocate(makeRequirements(4096, 1, 1u << BAR_TYPE), HOST_MEMORY, ResourceKind::Linear);
+	}
+	catch (const std::runtime_error&)
+	{
+		threw = true;
+	}
+	LVE_CHECK(threw);
+
+	threw = false;
+	try
+	{
+		allocator.allocate(makeRequirements(4096, 1, 1u << DEVICE_LOCAL_TYPE), HOST_MEMORY, ResourceKind::Linear);
+	}
+	catch (const std::runtime_error&)
+	{
+		threw = true;
+	}
+	LVE_CHECK(threw);
+}
+
+LVE_TEST(defragmentEmptiesTheLeastUsedBlock)
+{
+	MockAllocator allocator;
+
+	//eight quarter blocks fill two 64 MB blocks
+	std::vector<Allocation> allocations;
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		allocations.push_back(allocator.allocate(makeRequirements(16ull << 20), VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, ResourceKind::Linear));
+	}
+	LVE_CHECK(allocator.getStats().blocks == 2);
+	VkDeviceMemory firstBlock = allocations[0].memory;
+	VkDeviceMemory secondBlock = allocations[7].memory;
+	LVE_CHECK(firstBlock != secondBlock);
+
+	//both blocks are full, nothing can move
+	LVE_CHECK(allocator.defragment([](const Allocation&, const Allocation&) { LVE_CHECK(false); }) == 0);
+
+	//three left in the first block, one in the second
+	allocator.free(allocations[1]);
+	for (uint32_t i = 4; i < 7; i++)
+	{
+		allocator.free(allocations[i]);
+	}
+
+	Allocation& survivor = allocations[7];
+	uint32_t moves = allocator.defragment([&](const Allocation& from, const Allocation& to)
+		{
+			LVE_CHECK(from.memory == survivor.memory && from.offset == survivor.offset && from.size == survivor.size);
+			LVE_CHECK(to.memory == firstBlock && to.size == from.size);
+			LVE_CHECK(to.offset == (16ull << 20));
+			survivor = to;
+		});
+
+	LVE_CHECK(moves == 1);
+	LVE_CHECK(survivor.memory == firstBlock);
+	LVE_CHECK(allocator.getStats().blocks == 1 && allocator.liveMemoryCount() == 1);
+	LVE_CHECK(allocator.getStats().allocations == 4);
+
+	//the moved allocation frees like any other
+	for (size_t i : { 0, 2, 3, 7 })
+	{
+		allocator.free(allocations[i]);
+	}
+	LVE_CHECK(allocator.getStats().allocations == 0);
+}
+
+LVE_TEST(failedMappingFreesTheMemory)
+{
+	MockAllocator allocator;
+	allocator.failMapping = true;
+
+	for (VkDeviceSize size : { VkDeviceSize{ 4096 }, VkDeviceSize{ 100ull << 20 } })
+	{
+		bool threw = false;
+		try
+		{
+			allocator.allocate(makeRequirements(size), HOST_MEMORY, ResourceKind::Linear);
+		}
+		catch (const std::runtime_error&)
+		{
+			threw = true;
+		}
+		LVE_CHECK(threw);
+		LVE_CHECK(allocator.liveMemoryCount() == 0);
+		LVE_CHECK(allocator.getStats().blocks == 0 && allocator.getStats().dedicatedAllocations == 0);
+	}
+}
\ No newline at end of file
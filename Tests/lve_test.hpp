@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace lve::test
+{
+	// Minimal test registry: LVE_TEST defines a function main() runs, LVE_CHECK reports a failed condition and
+	// lets the test carry on so one run shows every broken expectation
+	struct TestCase
+	{
+		const char* name;
+		void (*function)();
+	};
+
+	inline std::vector<TestCase>& registry()
+	{
+		static std::vector<TestCase> testCases;
+		return testCases;
+	}
+
+	inline uint32_t& failureCount()
+	{
+		static uint32_t failures = 0;
+		return failures;
+	}
+
+	struct Registrar
+	{
+		Registrar(const char* name, void (*function)()) { registry().push_back({ name, function }); }
+	};
+
+	inline void check(bool passed, const char* condition, const char* file, int line)
+	{
+		if (!passed)
+		{
+			failureCount()++;
+			std::cout << "  " << file << ':' << line << ": check failed: " << condition << '\n';
+		}
+	}
+}
+
+#define LVE_TEST(name) \
+	static void name(); \
+	static lve::test::Registrar name##Registrar{ #name, name }; \
+	static void name()
+
+#define LVE_CHECK(condition) lve::test::check((condition), #condition, __FILE__, __LINE__)
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "lve_test.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+// CPU only tests of the engine's building blocks, no window or GPU needed. Pass a name prefix to run a subset
+int main(int argc, char** argv)
+{
+	const char* filter = argc > 1 ? argv[1] : "";
+
+	uint32_t run = 0;
+	uint32_t failedTests = 0;
+	for (const lve::test::TestCase& testCase : lve::test::registry())
+	{
+		if (std::strncmp(testCase.name, filter, std::strlen(filter)) != 0)
+		{
+			continue;
+		}
+
+		std::cout << testCase.name << '\n';
+		uint32_t failuresBefore = lve::test::failureCount();
+		try
+		{
+			testCase.function();
+		}
+		catch (const std::exception& e)
+		{
+			lve::test::failureCount()++;
+			std::cout << "  threw: " << e.what() << '\n';
+		}
+
+		run++;
+		if (lve::test::failureCount() != failuresBefore)
+		{
+			failedTests++;
+		}
+	}
+
+	std::cout << run - failedTests << '/' << run << " tests passed\n";
+	return failedTests == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "lve_test.hpp"
+#include "lve_meshlet.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace lve;
+
+struct TestMesh
+{
+	std::vector<glm::vec3> positions;
+	std::vector<uint32_t> indices;
+};
+
+//flat grid in the xy plane, every triangle faces +z
+static TestMesh makeGrid(uint32_t quads)
+{
+	TestMesh mesh;
+	uint32_t side = quads + 1;
+	for (uint32_t y = 0; y < side; y++)
+	{
+		for (uint32_t x = 0; x < side; x++)
+		{
+			mesh.positions.push_back({ static_cast<float>(x), static_cast<float>(y), 0.f });
+		}
+	}
+	for (uint32_t y = 0; y < quads; y++)
+	{
+		for (uint32_t x = 0; x < quads; x++)
+		{
+			uint32_t corner = y * side + x;
+			mesh.indices.insert(mesh.indices.end(), { corner, corner + 1, corner + side, corner + 1, corner + side + 1, corner + side });
+		}
+	}
+	return mesh;
+}
+
+//closed uv sphere with its triangles shuffled, so clusters can't just follow the index order
+static TestMesh makeShuffledSphere(uint32_t rings, uint32_t segments)
+{
+	TestMesh mesh;
+	for (uint32_t r = 0; r <= rings; r++)
+	{
+		float theta = 3.14159265f * r / rings;
+		for (uint32_t s = 0; s < segments; s++)
+		{
+			float phi = 6.2831853f * s / segments;
+			mesh.positions.push_back({ std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) });
+		}
+	}
+
+	std::vector<std::array<uint32_t, 3>> triangles;
+	for (uint32_t r = 0; r < rings; r++)
+	{
+		for (uint32_t s = 0; s < segments; s++)
+		{
+			uint32_t a = r * segments + s;
+			uint32_t b = r * segments + (s + 1) % segments;
+			uint32_t c = a + segments;
+			uint32_t d = b + segments;
+			triangles.push_back({ a, c, b });
+			triangles.push_back({ b, c, d });
+		}
+	}
+
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937{ 7 });
+	for (const auto& triangle : triangles)
+	{
+		mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+	}
+	return mesh;
+}
+
+static std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> sortedTriangles(const std::vector<uint32_t>& indices)
+{
+	std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> triangles;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		triangles.emplace_back(indices[i], indices[i + 1], indices[i + 2]);
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+//the model's index list rebuilt from the meshlets, in meshlet order
+static std::vector<uint32_t> expandMeshlets(const MeshletData& data)
+{
+	std::vector<uint32_t> indices;
+	for (const Meshlet& meshlet : data.meshlets)
+	{
+		for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++)
+		{
+			uint8_t local = data.triangles[(meshlet.triangleOffset * 3) + i];
+			indices.push_back(data.vertices[meshlet.vertexOffset + local]);
+		}
+	}
+	return indices;
+}
+
+LVE_TEST(meshletsStayWithinLimits)
+{
+	TestMesh grid = makeGrid(40);
+	TestMesh sphere = makeShuffledSphere(24, 32);
+
+	const uint32_t limits[][2] = { { LveMeshlets::MAX_VERTICES, LveMeshlets::MAX_TRIANGLES }, { 3, 1 }, { 10, 8 }, { 255, 512 } };
+	for (const TestMesh* mesh : { &grid, &sphere })
+	{
+		for (const auto& limit : limits)
+		{
+			MeshletData data = LveMeshlets::build(mesh->positions, mesh->indices, limit[0], limit[1]);
+			LVE_CHECK(!data.meshlets.empty());
+			LVE_CHECK(data.bounds.size() == data.meshlets.size());
+
+			for (const Meshlet& meshlet : data.meshlets)
+			{
+				LVE_CHECK(meshlet.vertexCount >= 3 && meshlet.vertexCount <= limit[0]);
+				LVE_CHECK(meshlet.triangleCount >= 1 && meshlet.triangleCount <= limit[1]);
+				LVE_CHECK(meshlet.vertexOffset + meshlet.vertexCount <= data.vertices.size());
+				LVE_CHECK((meshlet.triangleOffset + meshlet.triangleCount) * 3 <= data.triangles.size());
+
+				for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++)
+				{
+					LVE_CHECK(data.triangles[meshlet.triangleOffset * 3 + i] < meshlet.vertexCount);
+				}
+			}
+		}
+	}
+}
+
+LVE_TEST(meshletsEmitEveryTriangleOnce)
+{
+	TestMesh grid = makeGrid(40);
+	TestMesh sphere = makeShuffledSphere(24, 32);
+
+	for (const TestMesh* mesh : { &grid, &sphere })
+	{
+		for (uint32_t maxTriangles : { LveMeshlets::MAX_TRIANGLES, 1u, 7u })
+		{
+			MeshletData data = LveMeshlets::build(mesh->positions, mesh->indices, LveMeshlets::MAX_VERTICES, maxTriangles);
+
+			//corner order is part of the winding, so triangles are compared as given rather than as vertex sets
+			LVE_CHECK(sortedTriangles(expandMeshlets(data)) == sortedTriangles(mesh->indices));
+		}
+	}
+
+	LVE_CHECK(LveMeshlets::build({}, {}).meshlets.empty());
+}
+
+LVE_TEST(meshletSpheresContainTheirVertices)
+{
+	TestMesh sphere = makeShuffledSphere(24, 32);
+	for (glm::vec3& position : sphere.positions)
+	{
+		position = position * glm::vec3{ 3.f, 1.f, .5f } + glm::vec3{ 10.f, -4.f, 2.f };
+	}
+
+	MeshletData data = LveMeshlets::build(sphere.positions, sphere.indices);
+	for (size_t m = 0; m < data.meshlets.size(); m++)
+	{
+		const Meshlet& meshlet = data.meshlets[m];
+		glm::vec3 center{ data.bounds[m].sphere };
+		float radius = data.bounds[m].sphere.w;
+
+		for (uint32_t v = 0; v < meshlet.vertexCount; v++)
+		{
+			const glm::vec3& position = sphere.positions[data.vertices[meshlet.vertexOffset + v]];
+			LVE_CHECK(glm::length(position - center) <= radius * (1.f + 1e-5f));
+		}
+	}
+}
+
+LVE_TEST(backfaceConeOfAFlatMeshlet)
+{
+	TestMesh grid = makeGrid(4);
+	MeshletData data = LveMeshlets::build(grid.positions, grid.indices);
+	LVE_CHECK(data.meshlets.size() == 1);
+
+	const MeshletBounds& bounds = data.bounds[0];
+	LVE_CHECK(std::abs(bounds.cone.z - 1.f) < 1e-5f);
+	LVE_CHECK(bounds.cone.w < 1e-3f);
+
+	//the front of the grid is +z, cameras behind it only see back faces
+	glm::vec3 center{ bounds.sphere };
+	LVE_CHECK(LveMeshlets::isBackfacing(bounds, center + glm::vec3{ 0.f, 0.f, -20.f }));
+	LVE_CHECK(LveMeshlets::isBackfacing(bounds, center + glm::vec3{ 1.f, -2.f, -50.f }));
+	LVE_CHECK(!LveMeshlets::isBackfacing(bounds, center + glm::vec3{ 0.f, 0.f, 20.f }));
+	//close behind the plane the sphere covers view rays that graze the front, so it must not cull
+	LVE_CHECK(!LveMeshlets::isBackfacing(bounds, center + glm::vec3{ 0.f, 0.f, -.5f }));
+	LVE_CHECK(!LveMeshlets::isBackfacing(bounds, center + glm::vec3{ 100.f, 0.f, -1.f }));
+}
+
+LVE_TEST(backfaceConeOfKnownBounds)
+{
+	//normals within 30 degrees of +x, the sine of the half angle is 0.5
+	MeshletBounds bounds{ glm::vec4{ 0.f, 0.f, 0.f, 1.f }, glm::vec4{ 1.f, 0.f, 0.f, .5f } };
+
+	LVE_CHECK(LveMeshlets::isBackfacing(bounds, glm::vec3{ -10.f, 0.f, 0.f }));
+	LVE_CHECK(LveMeshlets::isBackfacing(bounds, glm::vec3{ -10.f, 4.f, 0.f }));
+	LVE_CHECK(!LveMeshlets::isBackfacing(bounds, glm::vec3{ -10.f, 20.f, 0.f }));
+	LVE_CHECK(!LveMeshlets::isBackfacing(bounds, glm::vec3{ 10.f, 0.f, 0.f }));
+	LVE_CHECK(!LveMeshlets::isBackfacing(bounds, glm::vec3{ 0.f, 0.f, 10.f }));
+
+	//a cutoff of 1 never culls, whatever the camera
+	MeshletBounds open{ glm::vec4{ 0.f, 0.f, 0.f, 1.f }, glm::vec4{ 0.f, 0.f, 0.f, 1.f } };
+	for (const glm::vec3& camera : { glm::vec3{ -10.f, 0.f, 0.f }, glm::vec3{ 0.f, 10.f, 0.f }, glm::vec3{ 0.f, 0.f, -100.f } })
+	{
+		LVE_CHECK(!LveMeshlets::isBackfacing(open, camera));
+	}
+}
+
+LVE_TEST(closedMeshletsNeverCull)
+{
+	//a whole sphere in one meshlet has normals all around, the builder must fall back to the never culling cone
+	TestMesh sphere = makeShuffledSphere(4, 6);
+	MeshletData data = LveMeshlets::build(sphere.positions, sphere.indices, 255, 512);
+	LVE_CHECK(data.meshlets.size() == 1);
+	LVE_CHECK(data.bounds[0].cone.w == 1.f);
+}
+
+LVE_TEST(frustumCullsSpheresOutsideClipSpace)
+{
+	//identity view projection: clip space is x and y in [-1, 1], z in [0, 1]
+	auto planes = LveMeshlets::extractFrustumPlanes(glm::mat4{ 1.f });
+
+	auto sphere = [](float x, float y, float z, float radius) { return MeshletBounds{ glm::vec4{ x, y, z, radius }, glm::vec4{ 0.f, 0.f, 0.f, 1.f } }; };
+	LVE_CHECK(!LveMeshlets::isOutsideFrustum(sphere(0.f, 0.f, .5f, .1f), planes));
+	LVE_CHECK(!LveMeshlets::isOutsideFrustum(sphere(1.5f, 0.f, .5f, 1.f), planes));
+	LVE_CHECK(LveMeshlets::isOutsideFrustum(sphere(3.f, 0.f, .5f, 1.f), planes));
+	LVE_CHECK(LveMeshlets::isOutsideFrustum(sphere(0.f, -3.f, .5f, 1.f), planes));
+	LVE_CHECK(LveMeshlets::isOutsideFrustum(sphere(0.f, 0.f, -2.f, 1.f), planes));
+	LVE_CHECK(LveMeshlets::isOutsideFrustum(sphere(0.f, 0.f, 2.5f, 1.f), planes));
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "lve_test.hpp"
+#include "lve_obj_stream_reader.hpp"
+
+//the reference the engine's OBJ import is checked against
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace lve;
+
+//the engine's models, relative to the Tests project directory Visual Studio runs the tests from
+static const char* MODEL_DIRECTORY = "../VulkanLearning_real1/models";
+
+// An OBJ file written by the test, and the exact floats behind every number in it. Each one is printed with nine
+// significant digits, so a correctly rounded parser has to give back the same bits
+struct GeneratedObj
+{
+	std::string path;
+	std::vector<float> vertices;
+	std::vector<float> normals;
+	std::vector<float> texcoords;
+};
+
+static std::string printFloat(float value)
+{
+	char text[32];
+	std::snprintf(text, sizeof(text), "%.9g", value);
+	return text;
+}
+
+//random values of mixed magnitude and sign, some small and large enough to be printed with an exponent
+static float randomFloat(std::mt19937& random)
+{
+	float mantissa = std::uniform_real_distribution<float>{ -1.f, 1.f }(random);
+	int exponent = std::uniform_int_distribution<int>{ -12, 12 }(random);
+	return std::ldexp(mantissa, exponent);
+}
+
+//every face form, w after a position, colored vertices, three component texcoords, negative indices, quads split
+//either way, groups, CRLF line ends and a last line without one. No polygons above quads, those are fanned where
+//tinyobj clips ears
+static GeneratedObj writeGeneratedObj()
+{
+	GeneratedObj obj;
+	obj.path = (std::filesystem::temp_directory_path() / "lve_obj_tests.obj").string();
+	std::ofstream file{ obj.path, std::ios::binary };
+	std::mt19937 random{ 11 };
+
+	auto writeValues = [&](const char* prefix, std::vector<float>& values, int count, const char* extra)
+		{
+			file << prefix;
+			for (int i = 0; i < count; i++)
+			{
+				float value = randomFloat(random);
+				values.push_back(value);
+				file << ' ' << printFloat(value);
+			}
+			file << extra << '\n';
+		};
+
+	file << "# generated by obj_tests.cpp\r\n";
+	for (int i = 0; i < 64; i++)
+	{
+		writeValues("v", obj.vertices, 3, i % 5 == 1 ? " 1.0" : i % 5 == 2 ? " 0.25 0.5 0.75" : "");
+		writeValues("vt", obj.texcoords, 2, i % 7 == 3 ? " 0" : "");
+		writeValues("vn", obj.normals, 3, "");
+	}
+
+	file << "o first\ng one\n";
+	for (int i = 1; i + 2 <= 64; i += 3)
+	{
+		file << "f " << i << '/' << i << '/' << i << ' ' << i + 1 << '/' << i + 1 << '/' << i + 1 << ' '
+			<< i + 2 << '/' << i + 2 << '/' << i + 2 << "\r\n";
+	}
+	file << "g two\nusemtl none\n";
+	for (int i = 1; i + 3 <= 64; i += 2)
+	{
+		file << "f " << i << ' ' << i + 1 << ' ' << i + 2 << ' ' << i + 3 << '\n';
+		file << "f " << i << "//" << i << ' ' << i + 3 << "//" << i + 3 << ' ' << i + 2 << "//" << i + 2 << ' '
+			<< i + 1 << "//" << i + 1 << '\n';
+		file << "f " << i << '/' << i << ' ' << i + 1 << '/' << i + 1 << ' ' << i + 2 << '/' << i + 2 << '\n';
+	}
+	file << "\n   f -1/-1/-1 -2/-2/-2 -3/-3/-3 -4/-4/-4\n";
+	file << "f -4 -3 -2 -1\n";
+	file << "o second\nf 1 2 3";
+	return obj;
+}
+
+//distance in representable floats between two values, +0 and -0 are the same point
+static uint64_t ulpDistance(float a, float b)
+{
+	auto ordered = [](float value)
+		{
+			int64_t bits = std::bit_cast<int32_t>(value);
+			return bits < 0 ? -(bits & 0x7FFFFFFF) : bits;
+		};
+	int64_t distance = ordered(a) - ordered(b);
+	return static_cast<uint64_t>(distance < 0 ? -distance : distance);
+}
+
+static uint64_t maxUlpDistance(const std::vector<float>& a, const std::vector<float>& b)
+{
+	uint64_t maxDistance = 0;
+	for (size_t i = 0; i < a.size() && i < b.size(); i++)
+	{
+		maxDistance = std::max(maxDistance, ulpDistance(a[i], b[i]));
+	}
+	return maxDistance;
+}
+
+//readCorners against tinyobj::LoadObj on one file. Corners have to be identical. Numbers may be one ulp apart,
+//tinyobj's own float parser isn't correctly rounded and objReaderRoundsCorrectly checks ours is
+static void checkAgainstTinyobj(const std::string& path)
+{
+	tinyobj::attrib_t expected;
+	std::vector<tinyobj::shape_t> shapes;
+	std::vector<tinyobj::material_t> materials;
+	std::string warn, err;
+	LVE_CHECK(tinyobj::LoadObj(&expected, &shapes, &materials, &warn, &err, path.c_str()));
+
+	std::vector<tinyobj::index_t> expectedCorners;
+	for (const tinyobj::shape_t& shape : shapes)
+	{
+		expectedCorners.insert(expectedCorners.end(), shape.mesh.indices.begin(), shape.mesh.indices.end());
+	}
+
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::index_t> corners;
+	LveObjStreamReader::readCorners(path, attrib, corners);
+
+	LVE_CHECK(corners.size() == expectedCorners.size());
+	size_t differentCorners = 0;
+	for (size_t i = 0; i < corners.size() && i < expectedCorners.size(); i++)
+	{
+		differentCorners += corners[i].vertex_index != expectedCorners[i].vertex_index ||
+			corners[i].normal_index != expectedCorners[i].normal_index ||
+			corners[i].texcoord_index != expectedCorners[i].texcoord_index;
+	}
+	LVE_CHECK(differentCorners == 0);
+
+	LVE_CHECK(attrib.vertices.size() == expected.vertices.size());
+	LVE_CHECK(attrib.normals.size() == expected.normals.size());
+	LVE_CHECK(attrib.texcoords.size() == expected.texcoords.size());
+	LVE_CHECK(maxUlpDistance(attrib.vertices, expected.vertices) <= 1);
+	LVE_CHECK(maxUlpDistance(attrib.normals, expected.normals) <= 1);
+	LVE_CHECK(maxUlpDistance(attrib.texcoords, expected.texcoords) <= 1);
+	if (differentCorners != 0 || corners.size() != expectedCorners.size())
+	{
+		std::cout << "  in " << path << '\n';
+	}
+}
+
+LVE_TEST(objReaderRoundsCorrectly)
+{
+	GeneratedObj obj = writeGeneratedObj();
+
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::index_t> corners;
+	LveObjStreamReader::readCorners(obj.path, attrib, corners);
+	std::filesystem::remove(obj.path);
+
+	LVE_CHECK(attrib.vertices == obj.vertices);
+	LVE_CHECK(attrib.normals == obj.normals);
+	LVE_CHECK(attrib.texcoords == obj.texcoords);
+}
+
+LVE_TEST(objCornersMatchTinyobj)
+{
+	GeneratedObj obj = writeGeneratedObj();
+	checkAgainstTinyobj(obj.path);
+	std::filesystem::remove(obj.path);
+
+	std::error_code error;
+	uint32_t models = 0;
+	for (const auto& entry : std::filesystem::directory_iterator{ MODEL_DIRECTORY, error })
+	{
+		if (entry.path().extension() == ".obj")
+		{
+			checkAgainstTinyobj(entry.path().string());
+			models++;
+		}
+	}
+	std::cout << "  compared " << models << " models from " << MODEL_DIRECTORY << '\n';
+}
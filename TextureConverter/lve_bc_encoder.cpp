@@ -0,0 +1,768 @@
+#include "lve_bc_encoder.hpp"
+#include "lve_thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#ifdef LVE_BC_ENCODER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace lve
+{
+	static constexpr uint32_t TEXEL_COUNT = 16;
+
+	//one array per channel, so the palette search loads four texels of a channel at once
+	struct BlockChannels
+	{
+		alignas(16) float values[4][TEXEL_COUNT];
+	};
+
+	struct Endpoints
+	{
+		float first[4];
+		float second[4];
+	};
+
+	//position of each index between the first and second endpoint
+	static constexpr float BC1_WEIGHTS[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+	static constexpr float BC4_WEIGHTS[8] = { 0.f, 1.f, 1.f / 7.f, 2.f / 7.f, 3.f / 7.f, 4.f / 7.f, 5.f / 7.f, 6.f / 7.f };
+	static constexpr uint32_t BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	static constexpr uint32_t RGB_CHANNELS[3] = { 0, 1, 2 };
+	static constexpr uint32_t RGBA_CHANNELS[4] = { 0, 1, 2, 3 };
+
+	//nearest palette entry for every texel, returns the summed squared error. palette[p][k] belongs to channels[k]
+	static float selectIndices(const BlockChannels& block, const uint32_t* channels, uint32_t channelCount,
+		const float (*palette)[4], uint32_t paletteSize, uint8_t indices[TEXEL_COUNT])
+	{
+		float error = 0.f;
+
+#ifdef LVE_BC_ENCODER_SSE2
+		for (uint32_t group = 0; group < TEXEL_COUNT; group += 4)
+		{
+			__m128 bestError = _mm_set1_ps(FLT_MAX);
+			__m128i bestIndex = _mm_setzero_si128();
+
+			for (uint32_t p = 0; p < paletteSize; p++)
+			{
+				__m128 distance = _mm_setzero_ps();
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					__m128 difference = _mm_sub_ps(_mm_load_ps(&block.values[channels[c]][group]), _mm_set1_ps(palette[p][c]));
+					distance = _mm_add_ps(distance, _mm_mul_ps(difference, difference));
+				}
+
+				//strictly closer only, so ties keep the lower index like the scalar path
+				__m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, bestError));
+				bestError = _mm_min_ps(distance, bestError);
+				bestIndex = _mm_or_si128(_mm_andnot_si128(closer, bestIndex),
+					_mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(p))));
+			}
+
+			alignas(16) float errors[4];
+			alignas(16) int32_t groupIndices[4];
+			_mm_store_ps(errors, bestError);
+			_mm_store_si128(reinterpret_cast<__m128i*>(groupIndices), bestIndex);
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				error += errors[i];
+				indices[group + i] = static_cast<uint8_t>(groupIndices[i]);
+			}
+		}
+#else
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			float bestError = FLT_MAX;
+			for (uint32_t p = 0; p < paletteSize; p++)
+			{
+				float distance = 0.f;
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					float difference = block.values[channels[c]][i] - palette[p][c];
+					distance += difference * difference;
+				}
+				if (distance < bestError)
+				{
+					bestError = distance;
+					indices[i] = static_cast<uint8_t>(p);
+				}
+			}
+			error += bestError;
+		}
+#endif
+
+		return error;
+	}
+
+	//endpoints along the principal axis of the texels, spanning the projections of all of them
+	static Endpoints fitPrincipalAxis(const BlockChannels& block, const uint32_t* channels, uint32_t channelCount)
+	{
+		float mean[4] = {};
+		for (uint32_t c = 0; c < channelCount; c++)
+		{
+			for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+			{
+				mean[c] += block.values[channels[c]][i];
+			}
+			mean[c] /= TEXEL_COUNT;
+		}
+
+		float covariance[4][4] = {};
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			for (uint32_t j = 0; j < channelCount; j++)
+			{
+				for (uint32_t k = 0; k < channelCount; k++)
+				{
+					covariance[j][k] += (block.values[channels[j]][i] - mean[j]) * (block.values[channels[k]][i] - mean[k]);
+				}
+			}
+		}
+
+		//power iteration, a few steps are plenty for 16 texels
+		float axis[4] = { 1.f, 1.f, 1.f, 1.f };
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = {};
+			float largest = 0.f;
+			for (uint32_t j = 0; j < channelCount; j++)
+			{
+				for (uint32_t k = 0; k < channelCount; k++)
+				{
+					next[j] += covariance[j][k] * axis[k];
+				}
+				largest = std::max(largest, std::abs(next[j]));
+			}
+			if (largest < 1e-6f)
+			{
+				break;
+			}
+			for (uint32_t j = 0; j < channelCount; j++)
+			{
+				axis[j] = next[j] / largest;
+			}
+		}
+
+		float length = 0.f;
+		for (uint32_t c = 0; c < channelCount; c++)
+		{
+			length += axis[c] * axis[c];
+		}
+		length = std::sqrt(length);
+
+		Endpoints endpoints{};
+		float minProjection = 0.f;
+		float maxProjection = 0.f;
+		if (length > 1e-6f)
+		{
+			minProjection = FLT_MAX;
+			maxProjection = -FLT_MAX;
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				axis[c] /= length;
+			}
+			for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+			{
+				float projection = 0.f;
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					projection += (block.values[channels[c]][i] - mean[c]) * axis[c];
+				}
+				minProjection = std::min(minProjection, projection);
+				maxProjection = std::max(maxProjection, projection);
+			}
+		}
+
+		for (uint32_t c = 0; c < channelCount; c++)
+		{
+			endpoints.first[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.f, 255.f);
+			endpoints.second[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.f, 255.f);
+		}
+		return endpoints;
+	}
+
+	//least squares endpoints for the chosen indices, false when there is nothing to solve (all texels on one index)
+	static bool refitEndpoints(const BlockChannels& block, const uint32_t* channels, uint32_t channelCount,
+		const uint8_t indices[TEXEL_COUNT], const float* weights, Endpoints& endpoints)
+	{
+		float a = 0.f;
+		float b = 0.f;
+		float c = 0.f;
+		float firstSum[4] = {};
+		float secondSum[4] = {};
+
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			float t = weights[indices[i]];
+			float s = 1.f - t;
+			a += s * s;
+			b += s * t;
+			c += t * t;
+			for (uint32_t k = 0; k < channelCount; k++)
+			{
+				float value = block.values[channels[k]][i];
+				firstSum[k] += s * value;
+				secondSum[k] += t * value;
+			}
+		}
+
+		float determinant = a * c - b * b;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (uint32_t k = 0; k < channelCount; k++)
+		{
+			endpoints.first[k] = std::clamp((c * firstSum[k] - b * secondSum[k]) / determinant, 0.f, 255.f);
+			endpoints.second[k] = std::clamp((a * secondSum[k] - b * firstSum[k]) / determinant, 0.f, 255.f);
+		}
+		return true;
+	}
+
+	class BitWriter
+	{
+	public:
+		BitWriter(uint8_t* output) : output{ output } {}
+
+		void write(uint32_t value, uint32_t count)
+		{
+			for (uint32_t i = 0; i < count; i++, position++)
+			{
+				output[position >> 3] |= static_cast<uint8_t>(((value >> i) & 1) << (position & 7));
+			}
+		}
+
+	private:
+		uint8_t* output;
+		uint32_t position = 0;
+	};
+
+	class BitReader
+	{
+	public:
+		BitReader(const uint8_t* input) : input{ input } {}
+
+		uint32_t read(uint32_t count)
+		{
+			uint32_t value = 0;
+			for (uint32_t i = 0; i < count; i++, position++)
+			{
+				value |= ((input[position >> 3] >> (position & 7)) & 1u) << i;
+			}
+			return value;
+		}
+
+	private:
+		const uint8_t* input;
+		uint32_t position = 0;
+	};
+
+	static uint16_t packColor565(const float color[3])
+	{
+		uint32_t r = static_cast<uint32_t>(std::lround(color[0] * 31.f / 255.f));
+		uint32_t g = static_cast<uint32_t>(std::lround(color[1] * 63.f / 255.f));
+		uint32_t b = static_cast<uint32_t>(std::lround(color[2] * 31.f / 255.f));
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	static void unpackColor565(uint16_t packed, uint32_t color[3])
+	{
+		uint32_t r = (packed >> 11) & 31;
+		uint32_t g = (packed >> 5) & 63;
+		uint32_t b = packed & 31;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	static void encodeBc1(const BlockChannels& block, uint32_t quality, uint8_t* output)
+	{
+		Endpoints endpoints = fitPrincipalAxis(block, RGB_CHANNELS, 3);
+
+		float bestError = FLT_MAX;
+		uint16_t bestColors[2] = {};
+		uint8_t bestIndices[TEXEL_COUNT] = {};
+
+		for (uint32_t iteration = 0; iteration <= quality; iteration++)
+		{
+			uint16_t color0 = packColor565(endpoints.first);
+			uint16_t color1 = packColor565(endpoints.second);
+			//four colour mode needs color0 above color1, the refit below follows the swap through the indices
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+			}
+
+			uint32_t first[3];
+			uint32_t second[3];
+			unpackColor565(color0, first);
+			unpackColor565(color1, second);
+
+			float palette[4][4] = {};
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				palette[0][c] = static_cast<float>(first[c]);
+				palette[1][c] = static_cast<float>(second[c]);
+				palette[2][c] = static_cast<float>((2 * first[c] + second[c] + 1) / 3);
+				palette[3][c] = static_cast<float>((first[c] + 2 * second[c] + 1) / 3);
+			}
+			//equal colours decode in three colour mode, where only index 0 is the solid colour
+			uint32_t paletteSize = color0 == color1 ? 1 : 4;
+
+			uint8_t indices[TEXEL_COUNT];
+			float error = selectIndices(block, RGB_CHANNELS, 3, palette, paletteSize, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestColors[0] = color0;
+				bestColors[1] = color1;
+				std::memcpy(bestIndices, indices, TEXEL_COUNT);
+			}
+			else
+			{
+				break;
+			}
+
+			if (paletteSize == 1 || !refitEndpoints(block, RGB_CHANNELS, 3, indices, BC1_WEIGHTS, endpoints))
+			{
+				break;
+			}
+		}
+
+		uint32_t packedIndices = 0;
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			packedIndices |= static_cast<uint32_t>(bestIndices[i]) << (i * 2);
+		}
+		std::memcpy(output, bestColors, sizeof(bestColors));
+		std::memcpy(output + 4, &packedIndices, sizeof(packedIndices));
+	}
+
+	static void encodeBc4(const BlockChannels& block, uint32_t channel, uint32_t quality, uint8_t* output)
+	{
+		const uint32_t channels[1] = { channel };
+
+		Endpoints endpoints{};
+		endpoints.first[0] = *std::max_element(block.values[channel], block.values[channel] + TEXEL_COUNT);
+		endpoints.second[0] = *std::min_element(block.values[channel], block.values[channel] + TEXEL_COUNT);
+
+		float bestError = FLT_MAX;
+		uint8_t bestValues[2] = {};
+		uint8_t bestIndices[TEXEL_COUNT] = {};
+
+		for (uint32_t iteration = 0; iteration <= quality; iteration++)
+		{
+			uint32_t value0 = static_cast<uint32_t>(std::lround(endpoints.first[0]));
+			uint32_t value1 = static_cast<uint32_t>(std::lround(endpoints.second[0]));
+			//eight value mode needs value0 above value1
+			if (value0 < value1)
+			{
+				std::swap(value0, value1);
+			}
+
+			float palette[8][4] = {};
+			palette[0][0] = static_cast<float>(value0);
+			palette[1][0] = static_cast<float>(value1);
+			for (uint32_t i = 2; i < 8; i++)
+			{
+				palette[i][0] = static_cast<float>(((8 - i) * value0 + (i - 1) * value1 + 3) / 7);
+			}
+			uint32_t paletteSize = value0 == value1 ? 1 : 8;
+
+			uint8_t indices[TEXEL_COUNT];
+			float error = selectIndices(block, channels, 1, palette, paletteSize, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestValues[0] = static_cast<uint8_t>(value0);
+				bestValues[1] = static_cast<uint8_t>(value1);
+				std::memcpy(bestIndices, indices, TEXEL_COUNT);
+			}
+			else
+			{
+				break;
+			}
+
+			if (paletteSize == 1 || !refitEndpoints(block, channels, 1, indices, BC4_WEIGHTS, endpoints))
+			{
+				break;
+			}
+		}
+
+		std::memset(output, 0, 8);
+		output[0] = bestValues[0];
+		output[1] = bestValues[1];
+		BitWriter writer{ output + 2 };
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			writer.write(bestIndices[i], 3);
+		}
+	}
+
+	//7 bits per channel plus a p-bit shared by all four channels of the endpoint
+	struct Bc7Endpoint
+	{
+		uint32_t values[4];
+		uint32_t pBit;
+	};
+
+	static Bc7Endpoint quantizeBc7Endpoint(const float color[4])
+	{
+		Bc7Endpoint best{};
+		float bestError = FLT_MAX;
+		for (uint32_t pBit = 0; pBit < 2; pBit++)
+		{
+			Bc7Endpoint candidate{};
+			candidate.pBit = pBit;
+			float error = 0.f;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				long quantized = std::lround((color[c] - static_cast<float>(pBit)) / 2.f);
+				candidate.values[c] = static_cast<uint32_t>(std::clamp(quantized, 0l, 127l));
+				float difference = static_cast<float>((candidate.values[c] << 1) | pBit) - color[c];
+				error += difference * difference;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				best = candidate;
+			}
+		}
+		return best;
+	}
+
+	static void buildBc7Palette(const Bc7Endpoint& first, const Bc7Endpoint& second, float palette[16][4])
+	{
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			uint32_t value0 = (first.values[c] << 1) | first.pBit;
+			uint32_t value1 = (second.values[c] << 1) | second.pBit;
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				palette[i][c] = static_cast<float>(((64 - BC7_WEIGHTS[i]) * value0 + BC7_WEIGHTS[i] * value1 + 32) >> 6);
+			}
+		}
+	}
+
+	static void encodeBc7(const BlockChannels& block, uint32_t quality, uint8_t* output)
+	{
+		float weights[16];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			weights[i] = static_cast<float>(BC7_WEIGHTS[i]) / 64.f;
+		}
+
+		Endpoints endpoints = fitPrincipalAxis(block, RGBA_CHANNELS, 4);
+
+		float bestError = FLT_MAX;
+		Bc7Endpoint bestEndpoints[2] = {};
+		uint8_t bestIndices[TEXEL_COUNT] = {};
+
+		for (uint32_t iteration = 0; iteration <= quality; iteration++)
+		{
+			Bc7Endpoint first = quantizeBc7Endpoint(endpoints.first);
+			Bc7Endpoint second = quantizeBc7Endpoint(endpoints.second);
+
+			float palette[16][4];
+			buildBc7Palette(first, second, palette);
+
+			uint8_t indices[TEXEL_COUNT];
+			float error = selectIndices(block, RGBA_CHANNELS, 4, palette, 16, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestEndpoints[0] = first;
+				bestEndpoints[1] = second;
+				std::memcpy(bestIndices, indices, TEXEL_COUNT);
+			}
+			else
+			{
+				break;
+			}
+
+			if (!refitEndpoints(block, RGBA_CHANNELS, 4, indices, weights, endpoints))
+			{
+				break;
+			}
+		}
+
+		//the first index is stored without its top bit, so it has to sit in the lower half of the palette
+		if (bestIndices[0] & 8)
+		{
+			std::swap(bestEndpoints[0], bestEndpoints[1]);
+			for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+			{
+				bestIndices[i] = static_cast<uint8_t>(15 - bestIndices[i]);
+			}
+		}
+
+		std::memset(output, 0, 16);
+		BitWriter writer{ output };
+		writer.write(1u << 6, 7);
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			writer.write(bestEndpoints[0].values[c], 7);
+			writer.write(bestEndpoints[1].values[c], 7);
+		}
+		writer.write(bestEndpoints[0].pBit, 1);
+		writer.write(bestEndpoints[1].pBit, 1);
+		writer.write(bestIndices[0], 3);
+		for (uint32_t i = 1; i < TEXEL_COUNT; i++)
+		{
+			writer.write(bestIndices[i], 4);
+		}
+	}
+
+	static void decodeBc1(const uint8_t* block, bool allowThreeColor, uint8_t texels[64])
+	{
+		uint16_t colors[2];
+		uint32_t packedIndices;
+		std::memcpy(colors, block, sizeof(colors));
+		std::memcpy(&packedIndices, block + 4, sizeof(packedIndices));
+
+		uint32_t palette[4][4] = {};
+		unpackColor565(colors[0], palette[0]);
+		unpackColor565(colors[1], palette[1]);
+		palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			if (colors[0] > colors[1] || !allowThreeColor)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		if (colors[0] <= colors[1] && allowThreeColor)
+		{
+			palette[3][3] = 0;
+		}
+
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			uint32_t index = (packedIndices >> (i * 2)) & 3;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				texels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+			}
+		}
+	}
+
+	static void decodeBc4(const uint8_t* block, uint32_t channel, uint8_t texels[64])
+	{
+		uint32_t value0 = block[0];
+		uint32_t value1 = block[1];
+
+		uint32_t palette[8];
+		palette[0] = value0;
+		palette[1] = value1;
+		if (value0 > value1)
+		{
+			for (uint32_t i = 2; i < 8; i++)
+			{
+				palette[i] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+			}
+		}
+		else
+		{
+			for (uint32_t i = 2; i < 6; i++)
+			{
+				palette[i] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		BitReader reader{ block + 2 };
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			texels[i * 4 + channel] = static_cast<uint8_t>(palette[reader.read(3)]);
+		}
+	}
+
+	static void decodeBc7(const uint8_t* block, uint8_t texels[64])
+	{
+		BitReader reader{ block };
+		if (reader.read(7) != (1u << 6))
+		{
+			assert(false && "Only BC7 mode 6 blocks can be decoded");
+			std::memset(texels, 0, 64);
+			return;
+		}
+
+		Bc7Endpoint endpoints[2] = {};
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			endpoints[0].values[c] = reader.read(7);
+			endpoints[1].values[c] = reader.read(7);
+		}
+		endpoints[0].pBit = reader.read(1);
+		endpoints[1].pBit = reader.read(1);
+
+		float palette[16][4];
+		buildBc7Palette(endpoints[0], endpoints[1], palette);
+
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			uint32_t index = reader.read(i == 0 ? 3 : 4);
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				texels[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+			}
+		}
+	}
+
+	uint32_t LveBcEncoder::blockSizeOf(Format format)
+	{
+		return format == Format::BC1 ? 8 : 16;
+	}
+
+	const char* LveBcEncoder::getFormatName(Format format)
+	{
+		switch (format)
+		{
+		case Format::BC1: return "BC1";
+		case Format::BC3: return "BC3";
+		case Format::BC5: return "BC5";
+		case Format::BC7: return "BC7";
+		}
+		return "?";
+	}
+
+	uint32_t LveBcEncoder::channelCountOf(Format format)
+	{
+		switch (format)
+		{
+		case Format::BC1: return 3;
+		case Format::BC5: return 2;
+		default: return 4;
+		}
+	}
+
+	void LveBcEncoder::encodeBlock(const uint8_t texels[64], Format format, uint32_t quality, uint8_t* block)
+	{
+		quality = std::min(quality, MAX_QUALITY);
+
+		BlockChannels channels;
+		for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				channels.values[c][i] = static_cast<float>(texels[i * 4 + c]);
+			}
+		}
+
+		switch (format)
+		{
+		case Format::BC1:
+			encodeBc1(channels, quality, block);
+			break;
+		case Format::BC3:
+			//alpha block first, then a BC1 colour block that is always read in four colour mode
+			encodeBc4(channels, 3, quality, block);
+			encodeBc1(channels, quality, block + 8);
+			break;
+		case Format::BC5:
+			encodeBc4(channels, 0, quality, block);
+			encodeBc4(channels, 1, quality, block + 8);
+			break;
+		case Format::BC7:
+			encodeBc7(channels, quality, block);
+			break;
+		}
+	}
+
+	void LveBcEncoder::decodeBlock(const uint8_t* block, Format format, uint8_t texels[64])
+	{
+		switch (format)
+		{
+		case Format::BC1:
+			decodeBc1(block, true, texels);
+			break;
+		case Format::BC3:
+			decodeBc1(block + 8, false, texels);
+			decodeBc4(block, 3, texels);
+			break;
+		case Format::BC5:
+			for (uint32_t i = 0; i < TEXEL_COUNT; i++)
+			{
+				texels[i * 4 + 2] = 0;
+				texels[i * 4 + 3] = 255;
+			}
+			decodeBc4(block, 0, texels);
+			decodeBc4(block + 8, 1, texels);
+			break;
+		case Format::BC7:
+			decodeBc7(block, texels);
+			break;
+		}
+	}
+
+	std::vector<uint8_t> LveBcEncoder::encodeImage(const uint8_t* rgba, uint32_t width, uint32_t height, Format format,
+		uint32_t quality)
+	{
+		uint32_t blocksWide = (width + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+		uint32_t blocksHigh = (height + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+		uint32_t blockSize = blockSizeOf(format);
+		std::vector<uint8_t> blocks(static_cast<size_t>(blocksWide) * blocksHigh * blockSize);
+
+		LveThreadPool::shared().parallelFor(blocksHigh, [&](uint32_t blockY)
+		{
+			uint8_t texels[64];
+			for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+			{
+				for (uint32_t y = 0; y < BLOCK_EXTENT; y++)
+				{
+					uint32_t sourceY = std::min(blockY * BLOCK_EXTENT + y, height - 1);
+					for (uint32_t x = 0; x < BLOCK_EXTENT; x++)
+					{
+						uint32_t sourceX = std::min(blockX * BLOCK_EXTENT + x, width - 1);
+						std::memcpy(&texels[(y * BLOCK_EXTENT + x) * 4], rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+					}
+				}
+				encodeBlock(texels, format, quality, &blocks[(static_cast<size_t>(blockY) * blocksWide + blockX) * blockSize]);
+			}
+		});
+
+		return blocks;
+	}
+
+	std::vector<uint8_t> LveBcEncoder::decodeImage(const uint8_t* blocks, uint32_t width, uint32_t height, Format format)
+	{
+		uint32_t blocksWide = (width + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+		uint32_t blocksHigh = (height + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+		uint32_t blockSize = blockSizeOf(format);
+		std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+
+		LveThreadPool::shared().parallelFor(blocksHigh, [&](uint32_t blockY)
+		{
+			uint8_t texels[64];
+			for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+			{
+				decodeBlock(&blocks[(static_cast<size_t>(blockY) * blocksWide + blockX) * blockSize], format, texels);
+
+				for (uint32_t y = 0; y < BLOCK_EXTENT && blockY * BLOCK_EXTENT + y < height; y++)
+				{
+					for (uint32_t x = 0; x < BLOCK_EXTENT && blockX * BLOCK_EXTENT + x < width; x++)
+					{
+						size_t target = (static_cast<size_t>(blockY * BLOCK_EXTENT + y) * width + blockX * BLOCK_EXTENT + x) * 4;
+						std::memcpy(&rgba[target], &texels[(y * BLOCK_EXTENT + x) * 4], 4);
+					}
+				}
+			}
+		});
+
+		return rgba;
+	}
+}
\ No newline at end of file
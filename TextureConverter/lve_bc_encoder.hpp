@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LVE_BC_ENCODER_SSE2 1
+#endif
+
+namespace lve
+{
+	// CPU encoder for the block compressed formats LveDdsTexture reads. Endpoints start on the principal axis of the
+	// block's colours and are refit to the chosen indices by least squares, the palette searches test four texels at
+	// a time with SSE2 where available. Images are encoded one block row per thread pool task. BC7 only uses mode 6,
+	// a single RGBA subset with 4 bit indices, which covers smooth colour and alpha well and is quick to search.
+	class LveBcEncoder
+	{
+	public:
+		enum class Format { BC1, BC3, BC5, BC7 };
+
+		static constexpr uint32_t BLOCK_EXTENT = 4;
+		//number of endpoint refits after the initial fit, each one keeps the result only when it lowers the error
+		static constexpr uint32_t DEFAULT_QUALITY = 2;
+		static constexpr uint32_t MAX_QUALITY = 8;
+
+		static uint32_t blockSizeOf(Format format);
+		static const char* getFormatName(Format format);
+		//colour channels the format stores, the rest decode to a constant
+		static uint32_t channelCountOf(Format format);
+
+		//rgba is width * height texels of RGBA8, blocks past the edge repeat the last row and column
+		static std::vector<uint8_t> encodeImage(const uint8_t* rgba, uint32_t width, uint32_t height, Format format,
+			uint32_t quality = DEFAULT_QUALITY);
+		static std::vector<uint8_t> decodeImage(const uint8_t* blocks, uint32_t width, uint32_t height, Format format);
+
+		//texels are 4x4 RGBA8 in rows
+		static void encodeBlock(const uint8_t texels[64], Format format, uint32_t quality, uint8_t* block);
+		//BC7 blocks must be mode 6, which is all encodeBlock writes
+		static void decodeBlock(const uint8_t* block, Format format, uint8_t texels[64]);
+	};
+}
\ No newline at end of file
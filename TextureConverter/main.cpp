@@ -0,0 +1,332 @@
+#include "lve_bc_encoder.hpp"
+#include "lve_dds.hpp"
+#include "lve_thread_pool.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using lve::LveBcEncoder;
+using lve::LveDdsTexture;
+
+// Offline converter from PNG/JPG (anything stb_image reads) to the BCn DDS files LveTextures picks up, and a CPU
+// only quality/speed benchmark of the encoder
+struct Options
+{
+	std::string input;
+	std::string output;
+	LveBcEncoder::Format format = LveBcEncoder::Format::BC7;
+	uint32_t quality = LveBcEncoder::DEFAULT_QUALITY;
+	bool srgb = true;
+	bool mips = true;
+	bool bench = false;
+};
+
+struct Image
+{
+	std::vector<uint8_t> rgba;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
+static void printUsage()
+{
+	std::cout <<
+		"usage: TextureConverter <input> [-o output.dds] [-f bc1|bc3|bc5|bc7] [-q 0-" << LveBcEncoder::MAX_QUALITY << "] [--linear] [--no-mips]\n"
+		"       TextureConverter --bench <input>\n"
+		"the output defaults to the input with a .dds extension, next to it, where the engine looks for it.\n"
+		"colour formats are written as sRGB unless --linear is given, BC5 is always linear\n";
+}
+
+static bool parseFormat(const std::string& name, LveBcEncoder::Format& format)
+{
+	if (name == "bc1") { format = LveBcEncoder::Format::BC1; return true; }
+	if (name == "bc3") { format = LveBcEncoder::Format::BC3; return true; }
+	if (name == "bc5") { format = LveBcEncoder::Format::BC5; return true; }
+	if (name == "bc7") { format = LveBcEncoder::Format::BC7; return true; }
+	return false;
+}
+
+static bool parseOptions(int argc, char** argv, Options& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (argument == "-o" && hasValue) { options.output = argv[++i]; }
+		else if (argument == "-f" && hasValue) { if (!parseFormat(argv[++i], options.format)) return false; }
+		else if (argument == "-q" && hasValue) { options.quality = static_cast<uint32_t>(std::atoi(argv[++i])); }
+		else if (argument == "--linear") { options.srgb = false; }
+		else if (argument == "--no-mips") { options.mips = false; }
+		else if (argument == "--bench") { options.bench = true; }
+		else if (!argument.empty() && argument[0] != '-' && options.input.empty()) { options.input = argument; }
+		else { return false; }
+	}
+	return !options.input.empty();
+}
+
+static Image loadImage(const std::string& filepath)
+{
+	int width, height, channels;
+	stbi_uc* pixels = stbi_load(filepath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+	if (!pixels)
+	{
+		throw std::runtime_error("failed to load " + filepath + "!");
+	}
+
+	Image image;
+	image.width = static_cast<uint32_t>(width);
+	image.height = static_cast<uint32_t>(height);
+	image.rgba.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+	stbi_image_free(pixels);
+	return image;
+}
+
+static float srgbToLinear(uint8_t value)
+{
+	static const std::array<float, 256> table = []
+	{
+		std::array<float, 256> result{};
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			float c = static_cast<float>(i) / 255.f;
+			result[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+		return result;
+	}();
+	return table[value];
+}
+
+static uint8_t linearToSrgb(float value)
+{
+	float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+	return static_cast<uint8_t>(std::clamp(c * 255.f + 0.5f, 0.f, 255.f));
+}
+
+//2x2 box filter, matching the engine's CPU mip path. sRGB colour is averaged in linear space
+static Image downsample(const Image& source, bool srgb)
+{
+	Image result;
+	result.width = std::max(source.width / 2, 1u);
+	result.height = std::max(source.height / 2, 1u);
+	result.rgba.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+	lve::LveThreadPool::shared().parallelFor(result.height, [&](uint32_t y)
+	{
+		const uint8_t* row0 = &source.rgba[static_cast<size_t>(std::min(y * 2, source.height - 1)) * source.width * 4];
+		const uint8_t* row1 = &source.rgba[static_cast<size_t>(std::min(y * 2 + 1, source.height - 1)) * source.width * 4];
+		uint8_t* out = &result.rgba[static_cast<size_t>(y) * result.width * 4];
+
+		for (uint32_t x = 0; x < result.width; x++)
+		{
+			uint32_t x0 = std::min(x * 2, source.width - 1) * 4;
+			uint32_t x1 = std::min(x * 2 + 1, source.width - 1) * 4;
+
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				if (srgb && c < 3)
+				{
+					float sum = srgbToLinear(row0[x0 + c]) + srgbToLinear(row0[x1 + c]) +
+						srgbToLinear(row1[x0 + c]) + srgbToLinear(row1[x1 + c]);
+					out[x * 4 + c] = linearToSrgb(sum * 0.25f);
+				}
+				else
+				{
+					uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+					out[x * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+	});
+	return result;
+}
+
+static uint32_t dxgiFormatOf(LveBcEncoder::Format format, bool srgb)
+{
+	switch (format)
+	{
+	case LveBcEncoder::Format::BC1: return srgb ? LveDdsTexture::DXGI_FORMAT_BC1_UNORM_SRGB : LveDdsTexture::DXGI_FORMAT_BC1_UNORM;
+	case LveBcEncoder::Format::BC3: return srgb ? LveDdsTexture::DXGI_FORMAT_BC3_UNORM_SRGB : LveDdsTexture::DXGI_FORMAT_BC3_UNORM;
+	case LveBcEncoder::Format::BC5: return LveDdsTexture::DXGI_FORMAT_BC5_UNORM;
+	case LveBcEncoder::Format::BC7: return srgb ? LveDdsTexture::DXGI_FORMAT_BC7_UNORM_SRGB : LveDdsTexture::DXGI_FORMAT_BC7_UNORM;
+	}
+	return 0;
+}
+
+//always with a DX10 header, the legacy FourCCs can't say sRGB or BC7
+static void writeDds(const std::string& filepath, uint32_t width, uint32_t height, uint32_t dxgiFormat,
+	const std::vector<std::vector<uint8_t>>& levels)
+{
+	constexpr uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000,
+		DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+	constexpr uint32_t DDPF_FOURCC = 0x4;
+	constexpr uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+	lve::DdsHeader header{};
+	header.size = sizeof(lve::DdsHeader);
+	header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+	header.height = height;
+	header.width = width;
+	header.pitchOrLinearSize = static_cast<uint32_t>(levels[0].size());
+	header.depth = 1;
+	header.mipMapCount = static_cast<uint32_t>(levels.size());
+	header.pixelFormat.size = sizeof(lve::DdsPixelFormat);
+	header.pixelFormat.flags = DDPF_FOURCC;
+	header.pixelFormat.fourCC = 0x30315844; //"DX10"
+	header.caps = DDSCAPS_TEXTURE | (levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+	lve::DdsHeaderDx10 dx10{};
+	dx10.dxgiFormat = dxgiFormat;
+	dx10.resourceDimension = 3; //texture 2D
+	dx10.arraySize = 1;
+
+	std::ofstream file{ filepath, std::ios::binary };
+	if (!file)
+	{
+		throw std::runtime_error("failed to open " + filepath + " for writing!");
+	}
+
+	uint32_t magic = LveDdsTexture::MAGIC;
+	file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(&dx10), sizeof(dx10));
+	for (const std::vector<uint8_t>& level : levels)
+	{
+		file.write(reinterpret_cast<const char*>(level.data()), static_cast<std::streamsize>(level.size()));
+	}
+	if (!file)
+	{
+		throw std::runtime_error("failed to write " + filepath + "!");
+	}
+}
+
+static void convert(const Options& options)
+{
+	bool srgb = options.srgb && options.format != LveBcEncoder::Format::BC5;
+	std::string output = options.output.empty() ? LveDdsTexture::pathFor(options.input) : options.output;
+
+	auto start = std::chrono::steady_clock::now();
+
+	Image level = loadImage(options.input);
+	uint32_t width = level.width;
+	uint32_t height = level.height;
+
+	std::vector<std::vector<uint8_t>> levels;
+	while (true)
+	{
+		levels.push_back(LveBcEncoder::encodeImage(level.rgba.data(), level.width, level.height, options.format, options.quality));
+		if (!options.mips || (level.width == 1 && level.height == 1))
+		{
+			break;
+		}
+		level = downsample(level, srgb);
+	}
+
+	writeDds(output, width, height, dxgiFormatOf(options.format, srgb), levels);
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << options.input << " -> " << output << " (" << LveBcEncoder::getFormatName(options.format) <<
+		(srgb ? " sRGB, " : ", ") << width << "x" << height << ", " << levels.size() << " levels) in " <<
+		seconds * 1000.0 << " ms\n";
+}
+
+//over the channels the format stores, infinity for a lossless result
+static double computePsnr(const std::vector<uint8_t>& original, const std::vector<uint8_t>& decoded, uint32_t channelCount)
+{
+	double squaredError = 0.0;
+	for (size_t i = 0; i < original.size(); i += 4)
+	{
+		for (uint32_t c = 0; c < channelCount; c++)
+		{
+			double difference = static_cast<double>(original[i + c]) - static_cast<double>(decoded[i + c]);
+			squaredError += difference * difference;
+		}
+	}
+
+	double meanSquaredError = squaredError / (static_cast<double>(original.size() / 4) * channelCount);
+	if (meanSquaredError == 0.0)
+	{
+		return INFINITY;
+	}
+	return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+//encodes the top level in every format and at every quality, best of a few runs so thread pool startup and
+//caches don't skew the timings
+static void bench(const Options& options)
+{
+	constexpr uint32_t RUNS = 3;
+	const LveBcEncoder::Format formats[] = {
+		LveBcEncoder::Format::BC1, LveBcEncoder::Format::BC3, LveBcEncoder::Format::BC5, LveBcEncoder::Format::BC7 };
+
+	Image image = loadImage(options.input);
+	double megapixels = static_cast<double>(image.width) * image.height / 1e6;
+
+	std::cout << options.input << ", " << image.width << "x" << image.height << ", " <<
+		lve::LveThreadPool::shared().getThreadCount() + 1 << " threads\n";
+	std::cout << "format quality     ms   MPix/s   PSNR dB\n";
+
+	for (LveBcEncoder::Format format : formats)
+	{
+		for (uint32_t quality = 0; quality <= LveBcEncoder::MAX_QUALITY; quality += 2)
+		{
+			double bestSeconds = INFINITY;
+			std::vector<uint8_t> blocks;
+			for (uint32_t run = 0; run < RUNS; run++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				blocks = LveBcEncoder::encodeImage(image.rgba.data(), image.width, image.height, format, quality);
+				bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+			}
+
+			std::vector<uint8_t> decoded = LveBcEncoder::decodeImage(blocks.data(), image.width, image.height, format);
+			double psnr = computePsnr(image.rgba, decoded, LveBcEncoder::channelCountOf(format));
+
+			char line[128];
+			std::snprintf(line, sizeof(line), "%-6s %7u %6.1f %8.1f %9.2f\n", LveBcEncoder::getFormatName(format),
+				quality, bestSeconds * 1000.0, megapixels / bestSeconds, psnr);
+			std::cout << line;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options))
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		if (options.bench)
+		{
+			bench(options);
+		}
+		else
+		{
+			convert(options);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 C:\VulkanSDK\1.3.296.0\Bin\glslc.exe shaders\simple_shader.frag -o shaders\simple_shader.frag.spv
 C:\VulkanSDK\1.3.296.0\Bin\glslc.exe shaders\simple_shader.vert -o shaders\simple_shader.vert.spv
+C:\VulkanSDK\1.3.296.0\Bin\glslc.exe shaders\simple_shader_packed.vert -o shaders\simple_shader_packed.vert.spv
 C:\VulkanSDK\1.3.296.0\Bin\glslc.exe shaders\point_light.frag -o shaders\point_light.frag.spv
 C:\VulkanSDK\1.3.296.0\Bin\glslc.exe shaders\point_light.vert -o shaders\point_light.vert.spv
 pause
\ No newline at end of file
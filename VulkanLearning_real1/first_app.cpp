@@ -23,9 +23,11 @@ namespace lve
     {
         globalPool = LveDescriptorPool::Builder(lveDevice)
             .setMaxSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-            .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
-            .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
+            .addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                LveSwapChain::MAX_FRAMES_IN_FLIGHT * textureRegistry.getCapacity())
             .build();
+        lveWindow.setIcon("./textures/NEEERDDDD.png");
         loadGameObjects();
     }
 
@@ -34,43 +36,30 @@ namespace lve
 
 	void FirstApp::run()
 	{
-        LveTextures texture{ lveDevice, lveWindow };
-
-        std::vector<std::unique_ptr<LveBuffer>> uboBuffers(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
-        for (int i = 0; i < uboBuffers.size(); i++)
-        {
-            uboBuffers[i] = std::make_unique<LveBuffer>(
-                lveDevice,
-                sizeof(GlobalUbo),
-                1,
-                VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, 
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-            uboBuffers[i]->map();
-        }
-
+        //the ubo lives in the renderer's frame allocator, each frame binds it at its own dynamic offset
+        //every texture sits in one array, objects index it through their push constants
         auto globalSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
-            .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
-            .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 1)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, VK_SHADER_STAGE_ALL_GRAPHICS)
+            .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT,
+                textureRegistry.getCapacity())
             .build();   
 
+        //textures were all loaded with the game objects, the sets are written once
+        std::vector<VkDescriptorImageInfo> imageInfos = textureRegistry.getDescriptorInfos();
+
         std::vector<VkDescriptorSet> globalDescriptorSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
         for (int i = 0; i < globalDescriptorSets.size(); i++)
         {
-            auto bufferInfo = uboBuffers[i]->descriptorInfo();
-
-            VkDescriptorImageInfo imageInfo{};
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imageInfo.imageView = texture.getTextureImageView();
-            imageInfo.sampler = texture.getSampler();
-
+            auto bufferInfo = lveRenderer.getFrameAllocator().descriptorInfo(sizeof(GlobalUbo));
 
             LveDescriptorWriter(*globalSetLayout, *globalPool)
                 .writeBuffer(0, &bufferInfo)
-                .writeImage(1, &imageInfo)
+                .writeImage(1, imageInfos.data(), textureRegistry.getCapacity())
                 .build(globalDescriptorSets[i]);
         }
 
-		SimpleRenderSystem simpleRenderSystem{ lveDevice, lveRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout()};
+		SimpleRenderSystem simpleRenderSystem{ lveDevice, lveRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout(),
+            textureRegistry.getCapacity() };
         PointLightSystem pointLightSystem{ lveDevice, lveRenderer.getSwapChainRenderPass(), globalSetLayout->getDescriptorSetLayout() };
         LveCamera camera{};
 
@@ -90,14 +79,26 @@ namespace lve
         double mouseY = 0.f;
 
         auto currentTime = std::chrono::high_resolution_clock::now();
+        float memoryLogTimer = 0.f;
 		while (!lveWindow.shouldClose())
 		{
 			glfwPollEvents();
+            modelLoader.update(gameObjects);
 
             auto newTime = std::chrono::high_resolution_clock::now();
             float frameTime = std::chrono::duration<float, std::chrono::seconds::period>(newTime - currentTime).count();
             //std::cout << "Framerate: " << 1 / frameTime << '\n';
             currentTime = newTime;
+
+            memoryLogTimer += frameTime;
+            if (memoryLogTimer >= MEMORY_LOG_INTERVAL)
+            {
+                //the pool holds on to evicted ranges until the frames still drawing them are done
+                modelRegistry.evictUnused();
+                modelRegistry.logStats();
+                lveDevice.logMemoryUsage();
+                memoryLogTimer = 0.f;
+            }
             
             cameraController.moveInPlaneXZ(lveWindow.getGLFWwindow(), frameTime, viewerObject, mouseX, mouseY);
             glfwGetCursorPos(lveWindow.getGLFWwindow(), &mouseX, &mouseY);
@@ -116,7 +117,9 @@ namespace lve
                     commandBuffer,
                     camera,
                     globalDescriptorSets[frameIndex],
-                    gameObjects
+                    gameObjects,
+                    lveRenderer.getFrameAllocator(),
+                    0
                 };
                 //update               
                 GlobalUbo ubo{};
@@ -124,8 +127,7 @@ namespace lve
                 ubo.view = camera.getView();
                 ubo.inverseView = camera.getInverseView();
                 pointLightSystem.update(frameInfo, ubo);
-                uboBuffers[frameIndex]->writeToBuffer(&ubo);
-                uboBuffers[frameIndex]->flush();    
+                frameInfo.globalUboOffset = frameInfo.frameAllocator.push(ubo).dynamicOffset();
 
                 //render
 				lveRenderer.beginSwapChainRenderPass(commandBuffer);
@@ -145,32 +147,36 @@ namespace lve
 
 	void FirstApp::loadGameObjects()
 	{
-        std::shared_ptr<LveModel> lveModel = LveModel::createModelFromFile(lveDevice, "models/pleasepot.obj");
+        //models stream in over the first frames, objects are skipped by the render system until theirs is uploaded
+        //the registry loads each path once, however many objects use it
+        uint32_t defaultTexture = textureRegistry.load("textures/IMG_5776.png");
+
         auto gameObj = LveGameObject::createGameObject();
-        gameObj.model = lveModel;
+        modelRegistry.attach("models/pleasepot.obj", gameObj.getId());
         gameObj.transform.translation = { .0f, .5f, 0.f };
         gameObj.transform.scale = { .25f, -.25f, .25f };
+        gameObj.textureIndex = defaultTexture;
         gameObjects.emplace(gameObj.getId(), std::move(gameObj));
 
-        lveModel = LveModel::createModelFromFile(lveDevice, "models/smooth_vase.obj");
         auto sVase = LveGameObject::createGameObject();
-        sVase.model = lveModel;
+        modelRegistry.attach("models/smooth_vase.obj", sVase.getId());
         sVase.transform.translation = { -.5f, .0f, 0.f };
         sVase.transform.scale = { 1.f, 1.f, 1.f };
+        sVase.textureIndex = defaultTexture;
         gameObjects.emplace(sVase.getId(), std::move(sVase));
 
-        lveModel = LveModel::createModelFromFile(lveDevice, "models/flat_vase.obj");
         auto vase = LveGameObject::createGameObject();
-        vase.model = lveModel;
+        modelRegistry.attach("models/flat_vase.obj", vase.getId());
         vase.transform.translation = { .5f, .0f, 0.f };
         vase.transform.scale = { 1.f, 1.f, 1.f };
+        vase.textureIndex = defaultTexture;
         gameObjects.emplace(vase.getId(), std::move(vase));
 
-        lveModel = LveModel::createModelFromFile(lveDevice, "models/quad.obj");
         auto quad = LveGameObject::createGameObject();
-        quad.model = lveModel;
+        modelRegistry.attach("models/quad.obj", quad.getId());
         quad.transform.translation = { 0.f, .5f, 0.f };
         quad.transform.scale = { 3.f, 1.f, 3.f };
+        quad.textureIndex = defaultTexture;
         gameObjects.emplace(quad.getId(), std::move(quad));
 
         std::vector<glm::vec3> lightColors{
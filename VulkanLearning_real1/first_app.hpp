@@ -3,10 +3,13 @@
 #include "lve_window.hpp"
 #include "lve_device.hpp"
 #include "lve_model.hpp"
+#include "lve_geometry_pool.hpp"
+#include "lve_model_loader.hpp"
+#include "lve_model_registry.hpp"
 #include "lve_game_object.hpp"
 #include "lve_renderer.hpp"
 #include "lve_descriptors.hpp"
-#include "lve_textures.hpp"
+#include "lve_texture_registry.hpp"
 
 #include <memory>
 #include <vector>
@@ -18,6 +21,8 @@ namespace lve
 	public:
 		static constexpr int WIDTH = 1600;
 		static constexpr int HEIGHT = 900;
+		//seconds between memory usage lines in the log, unused models are evicted right before each
+		static constexpr float MEMORY_LOG_INTERVAL = 10.f;
 
 
 		FirstApp();
@@ -34,6 +39,11 @@ namespace lve
 		LveWindow lveWindow{ WIDTH, HEIGHT, "thengine" };
 		LveDevice lveDevice{ lveWindow };
 		LveRenderer lveRenderer{ lveWindow, lveDevice };
+		//declared before the loader so it outlives every model
+		LveGeometryPool geometryPool{ lveDevice };
+		LveModelLoader modelLoader{ lveDevice, &geometryPool };
+		LveModelRegistry modelRegistry{ modelLoader };
+		LveTextureRegistry textureRegistry{ lveDevice };
 
 		std::unique_ptr<LveDescriptorPool> globalPool{};
 		LveGameObject::Map gameObjects;
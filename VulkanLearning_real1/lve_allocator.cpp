@@ -0,0 +1,464 @@
+#include "lve_allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <stdexcept>
+
+namespace lve
+{
+	LveBuddyAllocator::LveBuddyAllocator(VkDeviceSize size, VkDeviceSize minBlockSize) : size{ size }, minBlockSize{ minBlockSize }
+	{
+		assert(std::has_single_bit(size) && std::has_single_bit(minBlockSize) && size >= minBlockSize
+			&& "Buddy allocator sizes must be powers of two");
+
+		maxOrder = orderOf(size);
+		freeBlocks.resize(maxOrder + 1);
+		freeBlocks[maxOrder].insert(0);
+	}
+
+	uint32_t LveBuddyAllocator::orderOf(VkDeviceSize blockSize) const
+	{
+		return static_cast<uint32_t>(std::countr_zero(blockSize) - std::countr_zero(minBlockSize));
+	}
+
+	bool LveBuddyAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset, VkDeviceSize& reserved)
+	{
+		VkDeviceSize blockSize = std::bit_ceil(std::max({ size, alignment, minBlockSize }));
+		if (blockSize > this->size)
+		{
+			return false;
+		}
+
+		uint32_t order = orderOf(blockSize);
+		uint32_t available = order;
+		while (available <= maxOrder && freeBlocks[available].empty())
+		{
+			available++;
+		}
+		if (available > maxOrder)
+		{
+			return false;
+		}
+
+		offset = *freeBlocks[available].begin();
+		freeBlocks[available].erase(freeBlocks[available].begin());
+
+		//keep the first half, the second half becomes a free block one order down
+		while (available > order)
+		{
+			available--;
+			freeBlocks[available].insert(offset + (minBlockSize << available));
+		}
+
+		reserved = blockSize;
+		bytesUsed += blockSize;
+		return true;
+	}
+
+	void LveBuddyAllocator::free(VkDeviceSize offset, VkDeviceSize reserved)
+	{
+		uint32_t order = orderOf(reserved);
+		bytesUsed -= reserved;
+
+		while (order < maxOrder)
+		{
+			VkDeviceSize buddy = offset ^ (minBlockSize << order);
+			auto found = freeBlocks[order].find(buddy);
+			if (found == freeBlocks[order].end())
+			{
+				break;
+			}
+
+			freeBlocks[order].erase(found);
+			offset = std::min(offset, buddy);
+			order++;
+		}
+
+		freeBlocks[order].insert(offset);
+	}
+
+	LveAllocator::LveAllocator(VkDevice device, const VkPhysicalDeviceMemoryProperties& memoryProperties,
+		VkDeviceSize bufferImageGranularity, VkDeviceSize blockSize)
+		: device{ device }, memoryProperties{ memoryProperties }, blockSize{ blockSize }
+	{
+		assert(std::has_single_bit(blockSize) && blockSize >= MIN_ALLOCATION_SIZE && "Block size must be a power of two");
+
+		//every reservation starts and ends on a MIN_ALLOCATION_SIZE boundary, so with a granularity up to that size a
+		//buffer and an image can never end up on the same page
+		separateImageBlocks = bufferImageGranularity > MIN_ALLOCATION_SIZE;
+	}
+
+	LveAllocator::~LveAllocator()
+	{
+		assert(dedicatedAllocations == 0 && "Every resource must be destroyed before the allocator");
+
+		//not through freeMemory(), the overrides are gone by now and a mocked table has no device to free on
+		if (device != VK_NULL_HANDLE)
+		{
+			for (auto& block : blocks)
+			{
+				vkFreeMemory(device, block->memory, nullptr);
+			}
+		}
+	}
+
+	uint32_t LveAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties,
+		VkMemoryPropertyFlags preferredProperties) const
+	{
+		const VkMemoryPropertyFlags scoredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+		uint32_t bestType = UINT32_MAX;
+		int bestScore = INT_MIN;
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+		{
+			VkMemoryPropertyFlags flags = memoryProperties.memoryTypes[i].propertyFlags;
+			if (!(typeFilter & (1 << i)) || (flags & properties) != properties)
+			{
+				continue;
+			}
+
+			VkMemoryPropertyFlags unwanted = flags & scoredFlags & ~(properties | preferredProperties);
+			int score = 2 * std::popcount(flags & preferredProperties) - std::popcount(unwanted);
+			//ties keep the lower index, the order drivers list their types in
+			if (score > bestScore)
+			{
+				bestScore = score;
+				bestType = i;
+			}
+		}
+
+		if (bestType == UINT32_MAX)
+		{
+			throw std::runtime_error("failed to find suitable memory type!");
+		}
+		return bestType;
+	}
+
+	VkDeviceSize LveAllocator::getBlockSize(uint32_t memoryTypeIndex) const
+	{
+		//small heaps (like the 256 MB host visible device local one) get smaller blocks so one block never takes most of it
+		VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+		VkDeviceSize size = blockSize;
+		while (size > MIN_ALLOCATION_SIZE && size > heapSize / 8)
+		{
+			size >>= 1;
+		}
+		return size;
+	}
+
+	const char* LveAllocator::getCategoryName(Category category)
+	{
+		switch (category)
+		{
+		case Category::Mesh: return "mesh";
+		case Category::Texture: return "texture";
+		case Category::Uniform: return "uniform";
+		case Category::Staging: return "staging";
+		case Category::Attachment: return "attachment";
+		default: return "other";
+		}
+	}
+
+	LveAllocator::Allocation LveAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+		ResourceKind kind, VkMemoryPropertyFlags preferredProperties, Category category)
+	{
+		uint32_t memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, properties, preferredProperties);
+		if (!separateImageBlocks)
+		{
+			kind = ResourceKind::Linear;
+		}
+
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		Allocation allocation{};
+		allocation.category = category;
+
+		//the preferred type can sit on a small heap (BAR without resizable BAR), the required flags are enough then
+		uint32_t fallbackTypeIndex = findMemoryType(requirements.memoryTypeBits, properties);
+		if (!allocateFromType(memoryTypeIndex, requirements, kind, allocation) &&
+			(fallbackTypeIndex == memoryTypeIndex || !allocateFromType(fallbackTypeIndex, requirements, kind, allocation)))
+		{
+			throw std::runtime_error("failed to allocate device memory!");
+		}
+
+		categoryBytes[heapOf(allocation.memoryTypeIndex)][static_cast<uint32_t>(category)] += allocation.size;
+		return allocation;
+	}
+
+	bool LveAllocator::allocateFromType(uint32_t memoryTypeIndex, const VkMemoryRequirements& requirements, ResourceKind kind,
+		Allocation& allocation)
+	{
+		if (requirements.size > getBlockSize(memoryTypeIndex) / 2)
+		{
+			if (allocateMemory(memoryTypeIndex, requirements.size, allocation.memory) != VK_SUCCESS)
+			{
+				return false;
+			}
+
+			allocation.size = requirements.size;
+			allocation.mapped = mapNewMemory(allocation.memory, memoryTypeIndex);
+			allocation.memoryTypeIndex = memoryTypeIndex;
+			allocation.propertyFlags = memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+			dedicatedAllocations++;
+			dedicatedBytes += requirements.size;
+			dedicatedHeapBytes[heapOf(memoryTypeIndex)] += requirements.size;
+			return true;
+		}
+
+		if (allocateFromBlocks(memoryTypeIndex, kind, requirements.size, requirements.alignment, nullptr, allocation))
+		{
+			return true;
+		}
+		return createBlock(memoryTypeIndex, kind) != nullptr &&
+			allocateFromBlocks(memoryTypeIndex, kind, requirements.size, requirements.alignment, nullptr, allocation);
+	}
+
+	bool LveAllocator::allocateFromBlocks(uint32_t memoryTypeIndex, ResourceKind kind, VkDeviceSize size, VkDeviceSize alignment,
+		const Block* exclude, Allocation& allocation)
+	{
+		for (auto& block : blocks)
+		{
+			if (block.get() == exclude || block->memoryTypeIndex != memoryTypeIndex || block->kind != kind)
+			{
+				continue;
+			}
+
+			VkDeviceSize offset, reserved;
+			if (!block->buddy.allocate(size, alignment, offset, reserved))
+			{
+				continue;
+			}
+
+			block->allocations.emplace(offset, SubAllocation{ reserved, allocation.category });
+
+			allocation.memory = block->memory;
+			allocation.offset = offset;
+			allocation.size = reserved;
+			allocation.mapped = block->mapped != nullptr ? static_cast<char*>(block->mapped) + offset : nullptr;
+			allocation.memoryTypeIndex = memoryTypeIndex;
+			allocation.propertyFlags = memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+			allocation.block = block.get();
+			return true;
+		}
+		return false;
+	}
+
+	LveAllocator::Block* LveAllocator::createBlock(uint32_t memoryTypeIndex, ResourceKind kind)
+	{
+		VkDeviceSize size = getBlockSize(memoryTypeIndex);
+
+		VkDeviceMemory memory;
+		if (allocateMemory(memoryTypeIndex, size, memory) != VK_SUCCESS)
+		{
+			return nullptr;
+		}
+
+		void* mapped = mapNewMemory(memory, memoryTypeIndex);
+
+		blocks.push_back(std::make_unique<Block>(Block{ memory, mapped, memoryTypeIndex, kind, LveBuddyAllocator{ size, MIN_ALLOCATION_SIZE } }));
+		return blocks.back().get();
+	}
+
+	void* LveAllocator::mapNewMemory(VkDeviceMemory memory, uint32_t memoryTypeIndex)
+	{
+		if (!(memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+		{
+			return nullptr;
+		}
+
+		try
+		{
+			return mapMemory(memory, VK_WHOLE_SIZE);
+		}
+		catch (...)
+		{
+			freeMemory(memory);
+			throw;
+		}
+	}
+
+	void LveAllocator::releaseBlock(Block* block)
+	{
+		freeMemory(block->memory);
+		blocks.erase(std::find_if(blocks.begin(), blocks.end(), [block](const auto& candidate) { return candidate.get() == block; }));
+	}
+
+	void LveAllocator::free(Allocation& allocation)
+	{
+		if (!allocation.isValid())
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		uint32_t heapIndex = heapOf(allocation.memoryTypeIndex);
+		categoryBytes[heapIndex][static_cast<uint32_t>(allocation.category)] -= allocation.size;
+
+		if (allocation.block == nullptr)
+		{
+			freeMemory(allocation.memory);
+			dedicatedAllocations--;
+			dedicatedBytes -= allocation.size;
+			dedicatedHeapBytes[heapIndex] -= allocation.size;
+			allocation = Allocation{};
+			return;
+		}
+
+		Block* block = allocation.block;
+		block->buddy.free(allocation.offset, allocation.size);
+		block->allocations.erase(allocation.offset);
+		allocation = Allocation{};
+
+		//one empty block per memory type is kept around so a create / destroy loop does not hit the driver every time
+		if (block->buddy.isEmpty())
+		{
+			bool hasOther = std::any_of(blocks.begin(), blocks.end(), [block](const auto& other)
+				{
+					return other.get() != block && other->memoryTypeIndex == block->memoryTypeIndex && other->kind == block->kind;
+				});
+			if (hasOther)
+			{
+				releaseBlock(block);
+			}
+		}
+	}
+
+	uint32_t LveAllocator::defragment(const MoveCallback& move)
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		std::map<std::pair<uint32_t, ResourceKind>, std::vector<Block*>> groups;
+		for (auto& block : blocks)
+		{
+			groups[{ block->memoryTypeIndex, block->kind }].push_back(block.get());
+		}
+
+		uint32_t moves = 0;
+		for (auto& [key, group] : groups)
+		{
+			if (group.size() < 2)
+			{
+				continue;
+			}
+
+			Block* source = *std::min_element(group.begin(), group.end(),
+				[](const Block* a, const Block* b) { return a->buddy.getBytesUsed() < b->buddy.getBytesUsed(); });
+
+			//every allocation must find a new place before anything is moved, otherwise the block could not be released
+			std::vector<std::pair<Allocation, Allocation>> planned;
+			bool fits = true;
+			for (const auto& [offset, subAllocation] : source->allocations)
+			{
+				VkDeviceSize reserved = subAllocation.reserved;
+
+				Allocation from{};
+				from.memory = source->memory;
+				from.offset = offset;
+				from.size = reserved;
+				from.category = subAllocation.category;
+				from.mapped = source->mapped != nullptr ? static_cast<char*>(source->mapped) + offset : nullptr;
+				from.memoryTypeIndex = source->memoryTypeIndex;
+				from.propertyFlags = memoryProperties.memoryTypes[source->memoryTypeIndex].propertyFlags;
+				from.block = source;
+
+				//same memory type, so the per heap accounting does not change
+				Allocation to{};
+				to.category = subAllocation.category;
+				if (!allocateFromBlocks(key.first, key.second, reserved, reserved, source, to))
+				{
+					fits = false;
+					break;
+				}
+				planned.emplace_back(from, to);
+			}
+
+			if (!fits)
+			{
+				for (auto& [from, to] : planned)
+				{
+					to.block->buddy.free(to.offset, to.size);
+					to.block->allocations.erase(to.offset);
+				}
+				continue;
+			}
+
+			for (const auto& [from, to] : planned)
+			{
+				move(from, to);
+				moves++;
+			}
+			releaseBlock(source);
+		}
+		return moves;
+	}
+
+	LveAllocator::Stats LveAllocator::getStats()
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		Stats stats{};
+		stats.blocks = static_cast<uint32_t>(blocks.size());
+		stats.dedicatedAllocations = dedicatedAllocations;
+		stats.allocations = dedicatedAllocations;
+		stats.bytesReserved = dedicatedBytes;
+		stats.bytesUsed = dedicatedBytes;
+		for (const auto& block : blocks)
+		{
+			stats.allocations += static_cast<uint32_t>(block->allocations.size());
+			stats.bytesReserved += block->buddy.getSize();
+			stats.bytesUsed += block->buddy.getBytesUsed();
+		}
+		return stats;
+	}
+
+	std::vector<LveAllocator::HeapStats> LveAllocator::getHeapStats()
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		std::vector<HeapStats> heaps(memoryProperties.memoryHeapCount);
+		for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++)
+		{
+			heaps[i].size = memoryProperties.memoryHeaps[i].size;
+			heaps[i].flags = memoryProperties.memoryHeaps[i].flags;
+			heaps[i].bytesReserved = dedicatedHeapBytes[i];
+			heaps[i].categoryBytes = categoryBytes[i];
+			for (VkDeviceSize bytes : categoryBytes[i])
+			{
+				heaps[i].bytesUsed += bytes;
+			}
+		}
+		for (const auto& block : blocks)
+		{
+			heaps[heapOf(block->memoryTypeIndex)].bytesReserved += block->buddy.getSize();
+		}
+		return heaps;
+	}
+
+	VkResult LveAllocator::allocateMemory(uint32_t memoryTypeIndex, VkDeviceSize size, VkDeviceMemory& memory)
+	{
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = size;
+		allocInfo.memoryTypeIndex = memoryTypeIndex;
+		return vkAllocateMemory(device, &allocInfo, nullptr, &memory);
+	}
+
+	void LveAllocator::freeMemory(VkDeviceMemory memory)
+	{
+		vkFreeMemory(device, memory, nullptr);
+	}
+
+	void* LveAllocator::mapMemory(VkDeviceMemory memory, VkDeviceSize size)
+	{
+		void* mapped = nullptr;
+		if (vkMapMemory(device, memory, 0, size, 0, &mapped) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to map device memory!");
+		}
+		return mapped;
+	}
+}
\ No newline at end of file
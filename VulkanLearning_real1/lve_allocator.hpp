@@ -0,0 +1,193 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace lve
+{
+	// Power of two sub-allocation of a range, a block is split in halves until it fits the request and merged with its
+	// buddy again when both halves are free. Pure bookkeeping, it never touches the device.
+	class LveBuddyAllocator
+	{
+	public:
+		//size and minBlockSize must be powers of two
+		LveBuddyAllocator(VkDeviceSize size, VkDeviceSize minBlockSize);
+
+		//reserves the smallest block holding size, blocks are aligned to their own size so any power of two alignment
+		//up to the reserved size comes for free. false when no block is left
+		bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset, VkDeviceSize& reserved);
+		void free(VkDeviceSize offset, VkDeviceSize reserved);
+
+		VkDeviceSize getSize() const { return size; }
+		VkDeviceSize getBytesUsed() const { return bytesUsed; }
+		bool isEmpty() const { return bytesUsed == 0; }
+
+	private:
+		uint32_t orderOf(VkDeviceSize blockSize) const;
+
+		VkDeviceSize size;
+		VkDeviceSize minBlockSize;
+		uint32_t maxOrder;
+		std::vector<std::set<VkDeviceSize>> freeBlocks;	//offsets of free blocks, one set per order, order 0 is minBlockSize
+		VkDeviceSize bytesUsed = 0;
+	};
+
+	// Hands out device memory from large per memory type blocks, so creating a buffer or image no longer costs a
+	// vkAllocateMemory and the allocation count stays far below maxMemoryAllocationCount. Requests bigger than half a
+	// block get a dedicated allocation. When bufferImageGranularity is larger than the smallest buddy block, buffers
+	// and optimal tiling images go into separate blocks so they can never share a granularity page.
+	// Host visible blocks are mapped once for their whole lifetime.
+	class LveAllocator
+	{
+		struct Block;
+
+	public:
+		static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull << 20;
+		//smallest reservation, also a multiple of every nonCoherentAtomSize the spec allows (at most 256)
+		static constexpr VkDeviceSize MIN_ALLOCATION_SIZE = 256;
+
+		enum class ResourceKind
+		{
+			Linear,		//buffers and linear tiling images
+			Optimal		//optimal tiling images
+		};
+
+		//what the memory is used for, tracked per heap so usage can be broken down
+		enum class Category : uint32_t
+		{
+			Mesh,
+			Texture,
+			Uniform,
+			Staging,
+			Attachment,
+			Other
+		};
+		static constexpr uint32_t CATEGORY_COUNT = 6;
+		static const char* getCategoryName(Category category);
+
+		struct Allocation
+		{
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			VkDeviceSize offset = 0;
+			VkDeviceSize size = 0;		//reserved bytes, at least the requested size
+			void* mapped = nullptr;		//points at offset for host visible memory, null otherwise
+			uint32_t memoryTypeIndex = 0;
+			VkMemoryPropertyFlags propertyFlags = 0;	//of the memory type, may hold more than was asked for
+			Category category = Category::Other;
+
+			bool isValid() const { return memory != VK_NULL_HANDLE; }
+
+		private:
+			Block* block = nullptr;		//null for dedicated allocations
+
+			friend class LveAllocator;
+		};
+
+		struct Stats
+		{
+			uint32_t blocks = 0;
+			uint32_t dedicatedAllocations = 0;
+			uint32_t allocations = 0;
+			VkDeviceSize bytesReserved = 0;		//device memory held by blocks and dedicated allocations
+			VkDeviceSize bytesUsed = 0;			//part of it handed out
+		};
+
+		struct HeapStats
+		{
+			VkDeviceSize size = 0;
+			VkMemoryHeapFlags flags = 0;
+			VkDeviceSize bytesReserved = 0;		//blocks and dedicated allocations on this heap
+			VkDeviceSize bytesUsed = 0;
+			std::array<VkDeviceSize, CATEGORY_COUNT> categoryBytes{};	//bytesUsed split by Category
+		};
+
+		//the owner of oldAllocation must move its resource to newAllocation (recreate, bind, copy) before returning
+		using MoveCallback = std::function<void(const Allocation& oldAllocation, const Allocation& newAllocation)>;
+
+		//device may be VK_NULL_HANDLE when the device calls below are overridden, the memory properties can be a
+		//made up table then
+		LveAllocator(VkDevice device, const VkPhysicalDeviceMemoryProperties& memoryProperties,
+			VkDeviceSize bufferImageGranularity, VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+		virtual ~LveAllocator();
+
+		LveAllocator(const LveAllocator&) = delete;
+		LveAllocator& operator=(const LveAllocator&) = delete;
+
+		//preferred flags pick between the types holding all of properties, e.g. DEVICE_LOCAL for a host visible buffer
+		//written every frame lands in BAR memory when there is some. Falls back to any type with properties when the
+		//preferred one is out of memory, throws std::runtime_error when no type matches or the device is out of memory
+		Allocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceKind kind,
+			VkMemoryPropertyFlags preferredProperties = 0, Category category = Category::Other);
+		void free(Allocation& allocation);
+
+		//best scoring type holding all of properties: each preferred flag it has counts, each flag nobody asked for
+		//(a host visible type for a device only buffer, cached memory for write only staging) counts against it
+		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties,
+			VkMemoryPropertyFlags preferredProperties = 0) const;
+		const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const { return memoryProperties; }
+
+		//empties the least used block of each memory type into the others if they have room, calling move for every
+		//allocation that changes place, then releases the emptied block. The GPU must not be using any of the moved
+		//resources. Returns the number of moves
+		uint32_t defragment(const MoveCallback& move);
+
+		Stats getStats();
+		//one entry per memory heap, in heap order
+		std::vector<HeapStats> getHeapStats();
+
+	protected:
+		//the only calls that reach the device, override them to run the allocator against a mocked memory table
+		virtual VkResult allocateMemory(uint32_t memoryTypeIndex, VkDeviceSize size, VkDeviceMemory& memory);
+		virtual void freeMemory(VkDeviceMemory memory);
+		virtual void* mapMemory(VkDeviceMemory memory, VkDeviceSize size);
+
+	private:
+		struct SubAllocation
+		{
+			VkDeviceSize reserved = 0;
+			Category category = Category::Other;
+		};
+
+		struct Block
+		{
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			void* mapped = nullptr;
+			uint32_t memoryTypeIndex = 0;
+			ResourceKind kind = ResourceKind::Linear;
+			LveBuddyAllocator buddy;
+			std::map<VkDeviceSize, SubAllocation> allocations{};	//by offset, what defragment() has to move
+		};
+
+		VkDeviceSize getBlockSize(uint32_t memoryTypeIndex) const;
+		bool allocateFromType(uint32_t memoryTypeIndex, const VkMemoryRequirements& requirements, ResourceKind kind,
+			Allocation& allocation);
+		bool allocateFromBlocks(uint32_t memoryTypeIndex, ResourceKind kind, VkDeviceSize size, VkDeviceSize alignment,
+			const Block* exclude, Allocation& allocation);
+		//null when the device is out of memory
+		Block* createBlock(uint32_t memoryTypeIndex, ResourceKind kind);
+		//maps memory that was just allocated when its type is host visible, frees it again if mapping throws
+		void* mapNewMemory(VkDeviceMemory memory, uint32_t memoryTypeIndex);
+		void releaseBlock(Block* block);
+		uint32_t heapOf(uint32_t memoryTypeIndex) const { return memoryProperties.memoryTypes[memoryTypeIndex].heapIndex; }
+
+		VkDevice device;
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		VkDeviceSize blockSize;
+		bool separateImageBlocks;
+
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Block>> blocks;
+		uint32_t dedicatedAllocations = 0;
+		VkDeviceSize dedicatedBytes = 0;
+		std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> dedicatedHeapBytes{};
+		std::array<std::array<VkDeviceSize, CATEGORY_COUNT>, VK_MAX_MEMORY_HEAPS> categoryBytes{};
+	};
+}
\ No newline at end of file
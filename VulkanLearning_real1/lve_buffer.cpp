@@ -35,7 +35,8 @@ namespace lve {
         uint32_t instanceCount,
         VkBufferUsageFlags usageFlags,
         VkMemoryPropertyFlags memoryPropertyFlags,
-        VkDeviceSize minOffsetAlignment)
+        VkDeviceSize minOffsetAlignment,
+        VkMemoryPropertyFlags preferredMemoryPropertyFlags)
         : lveDevice{ device },
         instanceSize{ instanceSize },
         instanceCount{ instanceCount },
@@ -43,18 +44,20 @@ namespace lve {
         memoryPropertyFlags{ memoryPropertyFlags } {
         alignmentSize = getAlignment(instanceSize, minOffsetAlignment);
         bufferSize = alignmentSize * instanceCount;
-        device.createBuffer(bufferSize, usageFlags, memoryPropertyFlags, buffer, memory);
+        device.createBuffer(
+            bufferSize, usageFlags, memoryPropertyFlags, buffer, allocation, preferredMemoryPropertyFlags);
     }
 
     LveBuffer::~LveBuffer() {
         unmap();
-        vkDestroyBuffer(lveDevice.device(), buffer, nullptr);
-        vkFreeMemory(lveDevice.device(), memory, nullptr);
+        lveDevice.destroyBuffer(buffer, allocation);
     }
 
     /**
      * Map a memory range of this buffer. If successful, mapped points to the specified buffer range.
      *
+     * @note Host visible memory stays mapped by the allocator, this only points into that mapping
+     *
      * @param size (Optional) Size of the memory range to map. Pass VK_WHOLE_SIZE to map the complete
      * buffer range.
      * @param offset (Optional) Byte offset from beginning
@@ -62,20 +65,21 @@ namespace lve {
      * @return VkResult of the buffer mapping call
      */
     VkResult LveBuffer::map(VkDeviceSize size, VkDeviceSize offset) {
-        assert(buffer && memory && "Called map on buffer before create");
-        return vkMapMemory(lveDevice.device(), memory, offset, size, 0, &mapped);
+        assert(buffer && allocation.isValid() && "Called map on buffer before create");
+        if (allocation.mapped == nullptr) {
+            return VK_ERROR_MEMORY_MAP_FAILED;
+        }
+        mapped = static_cast<char*>(allocation.mapped) + offset;
+        return VK_SUCCESS;
     }
 
     /**
      * Unmap a mapped memory range
      *
-     * @note Does not return a result as vkUnmapMemory can't fail
+     * @note Does not return a result as unmapping can't fail, the memory itself stays mapped until it is freed
      */
     void LveBuffer::unmap() {
-        if (mapped) {
-            vkUnmapMemory(lveDevice.device(), memory);
-            mapped = nullptr;
-        }
+        mapped = nullptr;
     }
 
     /**
@@ -100,10 +104,39 @@ namespace lve {
         }
     }
 
+    /**
+     * Range of the underlying device memory, which other resources may share
+     *
+     * @note Widened to multiples of nonCoherentAtomSize, which never leaves the allocation: sub-allocations are
+     * aligned to LveAllocator::MIN_ALLOCATION_SIZE and a dedicated allocation ends with its memory
+     *
+     * @param size Size of the range, VK_WHOLE_SIZE for the rest of the buffer's allocation
+     * @param offset Byte offset from beginning of the buffer
+     *
+     * @return VkMappedMemoryRange for flush and invalidate
+     */
+    VkMappedMemoryRange LveBuffer::getMappedRange(VkDeviceSize size, VkDeviceSize offset) const {
+        VkDeviceSize atomSize = lveDevice.properties.limits.nonCoherentAtomSize;
+        VkDeviceSize allocationEnd = allocation.offset + allocation.size;
+        VkDeviceSize begin = allocation.offset + offset;
+        VkDeviceSize end = size == VK_WHOLE_SIZE ? allocationEnd : begin + size;
+
+        begin = begin / atomSize * atomSize;
+        end = (end + atomSize - 1) / atomSize * atomSize;
+
+        VkMappedMemoryRange mappedRange = {};
+        mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        mappedRange.memory = allocation.memory;
+        mappedRange.offset = begin;
+        // only a dedicated allocation of an odd size rounds past its end, the rest of its memory is all there is
+        mappedRange.size = end > allocationEnd ? VK_WHOLE_SIZE : end - begin;
+        return mappedRange;
+    }
+
     /**
      * Flush a memory range of the buffer to make it visible to the device
      *
-     * @note Only required for non-coherent memory
+     * @note Only required for non-coherent memory, returns VK_SUCCESS right away on coherent memory
      *
      * @param size (Optional) Size of the memory range to flush. Pass VK_WHOLE_SIZE to flush the
      * complete buffer range.
@@ -112,18 +145,17 @@ namespace lve {
      * @return VkResult of the flush call
      */
     VkResult LveBuffer::flush(VkDeviceSize size, VkDeviceSize offset) {
-        VkMappedMemoryRange mappedRange = {};
-        mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mappedRange.memory = memory;
-        mappedRange.offset = offset;
-        mappedRange.size = size;
+        if (isCoherent()) {
+            return VK_SUCCESS;
+        }
+        VkMappedMemoryRange mappedRange = getMappedRange(size, offset);
         return vkFlushMappedMemoryRanges(lveDevice.device(), 1, &mappedRange);
     }
 
     /**
      * Invalidate a memory range of the buffer to make it visible to the host
      *
-     * @note Only required for non-coherent memory
+     * @note Only required for non-coherent memory, returns VK_SUCCESS right away on coherent memory
      *
      * @param size (Optional) Size of the memory range to invalidate. Pass VK_WHOLE_SIZE to invalidate
      * the complete buffer range.
@@ -132,11 +164,10 @@ namespace lve {
      * @return VkResult of the invalidate call
      */
     VkResult LveBuffer::invalidate(VkDeviceSize size, VkDeviceSize offset) {
-        VkMappedMemoryRange mappedRange = {};
-        mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mappedRange.memory = memory;
-        mappedRange.offset = offset;
-        mappedRange.size = size;
+        if (isCoherent()) {
+            return VK_SUCCESS;
+        }
+        VkMappedMemoryRange mappedRange = getMappedRange(size, offset);
         return vkInvalidateMappedMemoryRanges(lveDevice.device(), 1, &mappedRange);
     }
 
@@ -12,7 +12,8 @@ namespace lve {
             uint32_t instanceCount,
             VkBufferUsageFlags usageFlags,
             VkMemoryPropertyFlags memoryPropertyFlags,
-            VkDeviceSize minOffsetAlignment = 1);
+            VkDeviceSize minOffsetAlignment = 1,
+            VkMemoryPropertyFlags preferredMemoryPropertyFlags = 0);
         ~LveBuffer();
 
         LveBuffer(const LveBuffer&) = delete;
@@ -38,15 +39,20 @@ namespace lve {
         VkDeviceSize getAlignmentSize() const { return instanceSize; }
         VkBufferUsageFlags getUsageFlags() const { return usageFlags; }
         VkMemoryPropertyFlags getMemoryPropertyFlags() const { return memoryPropertyFlags; }
+        // whether the memory it ended up in is coherent, flush and invalidate do nothing then
+        bool isCoherent() const { return allocation.propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT; }
         VkDeviceSize getBufferSize() const { return bufferSize; }
 
-    private:
+        // instanceSize rounded up to minOffsetAlignment, which must be a power of two
         static VkDeviceSize getAlignment(VkDeviceSize instanceSize, VkDeviceSize minOffsetAlignment);
 
+    private:
+        VkMappedMemoryRange getMappedRange(VkDeviceSize size, VkDeviceSize offset) const;
+
         LveDevice& lveDevice;
         void* mapped = nullptr;
         VkBuffer buffer = VK_NULL_HANDLE;
-        VkDeviceMemory memory = VK_NULL_HANDLE;
+        LveAllocator::Allocation allocation{};
 
         VkDeviceSize bufferSize;
         uint32_t instanceCount;
@@ -0,0 +1,162 @@
+#include "lve_dds.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace lve
+{
+	static_assert(sizeof(DdsHeader) == 124, "DDS header layout is fixed by the format");
+	static_assert(sizeof(DdsHeaderDx10) == 20, "DDS DX10 header layout is fixed by the format");
+
+	static constexpr uint32_t DDPF_FOURCC = 0x4;
+	static constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+	static constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+	static constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+	static constexpr uint32_t makeFourCC(char a, char b, char c, char d)
+	{
+		return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) |
+			(static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+	}
+
+	static VkFormat formatFromFourCC(uint32_t fourCC)
+	{
+		//legacy headers say nothing about the colour space, the converter writes DX10 headers for sRGB data
+		switch (fourCC)
+		{
+		case makeFourCC('D', 'X', 'T', '1'): return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+		case makeFourCC('D', 'X', 'T', '5'): return VK_FORMAT_BC3_UNORM_BLOCK;
+		case makeFourCC('A', 'T', 'I', '2'):
+		case makeFourCC('B', 'C', '5', 'U'): return VK_FORMAT_BC5_UNORM_BLOCK;
+		default: return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+	static VkFormat formatFromDxgi(uint32_t dxgiFormat)
+	{
+		switch (dxgiFormat)
+		{
+		case LveDdsTexture::DXGI_FORMAT_BC1_UNORM: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+		case LveDdsTexture::DXGI_FORMAT_BC1_UNORM_SRGB: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+		case LveDdsTexture::DXGI_FORMAT_BC3_UNORM: return VK_FORMAT_BC3_UNORM_BLOCK;
+		case LveDdsTexture::DXGI_FORMAT_BC3_UNORM_SRGB: return VK_FORMAT_BC3_SRGB_BLOCK;
+		case LveDdsTexture::DXGI_FORMAT_BC5_UNORM: return VK_FORMAT_BC5_UNORM_BLOCK;
+		case LveDdsTexture::DXGI_FORMAT_BC5_SNORM: return VK_FORMAT_BC5_SNORM_BLOCK;
+		case LveDdsTexture::DXGI_FORMAT_BC7_UNORM: return VK_FORMAT_BC7_UNORM_BLOCK;
+		case LveDdsTexture::DXGI_FORMAT_BC7_UNORM_SRGB: return VK_FORMAT_BC7_SRGB_BLOCK;
+		default: return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+	std::string LveDdsTexture::pathFor(const std::string& sourcePath)
+	{
+		return std::filesystem::path{ sourcePath }.replace_extension(".dds").string();
+	}
+
+	uint32_t LveDdsTexture::blockSizeOf(VkFormat format)
+	{
+		switch (format)
+		{
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+			return 8;
+		case VK_FORMAT_BC3_UNORM_BLOCK:
+		case VK_FORMAT_BC3_SRGB_BLOCK:
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+		case VK_FORMAT_BC5_SNORM_BLOCK:
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	LveDdsTexture::LveDdsTexture(const std::string& filepath) : file{ filepath }
+	{
+		if (file.isOpen() && !parse())
+		{
+			levels.clear();
+		}
+	}
+
+	bool LveDdsTexture::parse()
+	{
+		const char* data = file.getData();
+		size_t fileSize = file.getSize();
+
+		size_t offset = sizeof(uint32_t) + sizeof(DdsHeader);
+		if (fileSize < offset)
+		{
+			return false;
+		}
+
+		uint32_t magic;
+		std::memcpy(&magic, data, sizeof(magic));
+		DdsHeader header;
+		std::memcpy(&header, data + sizeof(uint32_t), sizeof(header));
+
+		if (magic != MAGIC || header.size != sizeof(DdsHeader) || !(header.pixelFormat.flags & DDPF_FOURCC) ||
+			(header.caps2 & DDSCAPS2_CUBEMAP) || header.width == 0 || header.height == 0)
+		{
+			return false;
+		}
+
+		if (header.pixelFormat.fourCC == makeFourCC('D', 'X', '1', '0'))
+		{
+			if (fileSize < offset + sizeof(DdsHeaderDx10))
+			{
+				return false;
+			}
+			DdsHeaderDx10 dx10;
+			std::memcpy(&dx10, data + offset, sizeof(dx10));
+			offset += sizeof(DdsHeaderDx10);
+
+			if (dx10.resourceDimension != DDS_DIMENSION_TEXTURE2D || dx10.arraySize > 1)
+			{
+				return false;
+			}
+			format = formatFromDxgi(dx10.dxgiFormat);
+		}
+		else
+		{
+			format = formatFromFourCC(header.pixelFormat.fourCC);
+		}
+
+		blockSize = blockSizeOf(format);
+		if (blockSize == 0)
+		{
+			return false;
+		}
+
+		//the chain may stop early, but never runs past 1x1
+		uint32_t levelCount = (header.flags & DDSD_MIPMAPCOUNT) ? std::max(header.mipMapCount, 1u) : 1u;
+		uint32_t width = header.width;
+		uint32_t height = header.height;
+
+		for (uint32_t i = 0; i < levelCount; i++)
+		{
+			size_t blocksWide = (width + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+			size_t blocksHigh = (height + BLOCK_EXTENT - 1) / BLOCK_EXTENT;
+			size_t levelSize = blocksWide * blocksHigh * blockSize;
+			if (fileSize - offset < levelSize)
+			{
+				return false;
+			}
+
+			levels.push_back(Level{ data + offset, levelSize, width, height });
+			offset += levelSize;
+
+			if (width == 1 && height == 1)
+			{
+				break;
+			}
+			width = std::max(width / 2, 1u);
+			height = std::max(height / 2, 1u);
+		}
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "lve_mapped_file.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lve
+{
+	// On disk layout of a DDS file, "DDS " | DdsHeader | DdsHeaderDx10 when the FourCC is "DX10" | levels, largest first
+	struct DdsPixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t rgbBitCount;
+		uint32_t rBitMask;
+		uint32_t gBitMask;
+		uint32_t bBitMask;
+		uint32_t aBitMask;
+	};
+
+	struct DdsHeader
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		DdsPixelFormat pixelFormat;
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+	};
+
+	struct DdsHeaderDx10
+	{
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+
+	// Block compressed 2D texture with pre-baked mips read from a DDS file, BC1, BC3, BC5 and BC7 only. The file stays
+	// mapped and the levels point into it, so uploading is a copy from the mapping into the staging ring, no decoding
+	class LveDdsTexture
+	{
+	public:
+		static constexpr uint32_t MAGIC = 0x20534444; //"DDS "
+		static constexpr uint32_t BLOCK_EXTENT = 4;
+
+		//the DXGI_FORMAT values of the formats above, for writing DX10 headers
+		static constexpr uint32_t DXGI_FORMAT_BC1_UNORM = 71;
+		static constexpr uint32_t DXGI_FORMAT_BC1_UNORM_SRGB = 72;
+		static constexpr uint32_t DXGI_FORMAT_BC3_UNORM = 77;
+		static constexpr uint32_t DXGI_FORMAT_BC3_UNORM_SRGB = 78;
+		static constexpr uint32_t DXGI_FORMAT_BC5_UNORM = 83;
+		static constexpr uint32_t DXGI_FORMAT_BC5_SNORM = 84;
+		static constexpr uint32_t DXGI_FORMAT_BC7_UNORM = 98;
+		static constexpr uint32_t DXGI_FORMAT_BC7_UNORM_SRGB = 99;
+
+		struct Level
+		{
+			const char* data = nullptr;
+			size_t size = 0;
+			uint32_t width = 0;
+			uint32_t height = 0;
+		};
+
+		//same path with the extension swapped for .dds, where the converter puts its output
+		static std::string pathFor(const std::string& sourcePath);
+		//bytes per 4x4 block, 0 for anything that isn't a supported BC format
+		static uint32_t blockSizeOf(VkFormat format);
+
+		//isOpen() is false when the file is missing, malformed or in a format this doesn't read
+		LveDdsTexture(const std::string& filepath);
+
+		LveDdsTexture(const LveDdsTexture&) = delete;
+		LveDdsTexture& operator=(const LveDdsTexture&) = delete;
+
+		bool isOpen() const { return !levels.empty(); }
+		VkFormat getFormat() const { return format; }
+		uint32_t getWidth() const { return levels[0].width; }
+		uint32_t getHeight() const { return levels[0].height; }
+		uint32_t getBlockSize() const { return blockSize; }
+		const std::vector<Level>& getLevels() const { return levels; }
+
+	private:
+		bool parse();
+
+		LveMappedFile file;
+		VkFormat format = VK_FORMAT_UNDEFINED;
+		uint32_t blockSize = 0;
+		std::vector<Level> levels;
+	};
+}
\ No newline at end of file
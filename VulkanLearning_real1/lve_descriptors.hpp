@@ -90,7 +90,8 @@ namespace lve {
         LveDescriptorWriter(LveDescriptorSetLayout& setLayout, LveDescriptorPool& pool);
 
         LveDescriptorWriter& writeBuffer(uint32_t binding, VkDescriptorBufferInfo* bufferInfo);
-        LveDescriptorWriter& writeImage(uint32_t binding, VkDescriptorImageInfo* imageInfo);
+        // count is the number of elements of an array binding, imageInfo points to one per element
+        LveDescriptorWriter& writeImage(uint32_t binding, VkDescriptorImageInfo* imageInfo, uint32_t count = 1);
 
         bool build(VkDescriptorSet& set);
         void overwrite(VkDescriptorSet& set);
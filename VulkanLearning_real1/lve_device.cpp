@@ -1,9 +1,12 @@
 #include "lve_device.hpp"
+#include "lve_staging_ring.hpp"
 
 // std headers
 #include <cstring>
+#include <iomanip>
 #include <iostream>
 #include <set>
+#include <sstream>
 #include <unordered_set>
 
 namespace lve {
@@ -46,6 +49,30 @@ void DestroyDebugUtilsMessengerEXT(
   }
 }
 
+// allocation categories for the memory report, taken from what the resource is created for
+static LveAllocator::Category bufferCategory(VkBufferUsageFlags usage) {
+  if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) {
+    return LveAllocator::Category::Mesh;
+  }
+  if (usage & (VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)) {
+    return LveAllocator::Category::Uniform;
+  }
+  if (usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT) {
+    return LveAllocator::Category::Staging;
+  }
+  return LveAllocator::Category::Other;
+}
+
+static LveAllocator::Category imageCategory(VkImageUsageFlags usage) {
+  if (usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) {
+    return LveAllocator::Category::Attachment;
+  }
+  if (usage & VK_IMAGE_USAGE_SAMPLED_BIT) {
+    return LveAllocator::Category::Texture;
+  }
+  return LveAllocator::Category::Other;
+}
+
 // class member functions
 LveDevice::LveDevice(LveWindow &window) : window{window} {
   createInstance();
@@ -53,11 +80,18 @@ LveDevice::LveDevice(LveWindow &window) : window{window} {
   createSurface();
   pickPhysicalDevice();
   createLogicalDevice();
+  createAllocator();
   createCommandPool();
+  stagingRing_ = std::make_unique<LveStagingRing>(*this);
 }
 
 LveDevice::~LveDevice() {
+  stagingRing_.reset();
+  if (transferCommandPool != commandPool) {
+    vkDestroyCommandPool(device_, transferCommandPool, nullptr);
+  }
   vkDestroyCommandPool(device_, commandPool, nullptr);
+  allocator_.reset();
   vkDestroyDevice(device_, nullptr);
 
   if (enableValidationLayers) {
@@ -79,7 +113,8 @@ void LveDevice::createInstance() {
   appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
   appInfo.pEngineName = "No Engine";
   appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-  appInfo.apiVersion = VK_API_VERSION_1_0;
+  // 1.1 for vkGetPhysicalDeviceMemoryProperties2, which the memory budget query goes through
+  appInfo.apiVersion = VK_API_VERSION_1_1;
 
   VkInstanceCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -153,8 +188,11 @@ void LveDevice::pickPhysicalDevice() {
 void LveDevice::createLogicalDevice() {
   QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
 
+  graphicsFamily_ = indices.graphicsFamily;
+  transferFamily_ = indices.transferFamilyHasValue ? indices.transferFamily : indices.graphicsFamily;
+
   std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-  std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+  std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily, transferFamily_};
 
   float queuePriority = 1.0f;
   for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -166,8 +204,16 @@ void LveDevice::createLogicalDevice() {
     queueCreateInfos.push_back(queueCreateInfo);
   }
 
+  VkPhysicalDeviceFeatures supportedFeatures;
+  vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
   VkPhysicalDeviceFeatures deviceFeatures = {};
   deviceFeatures.samplerAnisotropy = VK_TRUE;
+  // the texture registry's sampler array is indexed with a push constant
+  deviceFeatures.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+  // BC formats are optional, without them textures fall back to uncompressed ones
+  deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+  textureCompressionBCSupported_ = supportedFeatures.textureCompressionBC == VK_TRUE;
 
   VkDeviceCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -176,8 +222,15 @@ void LveDevice::createLogicalDevice() {
   createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
   createInfo.pEnabledFeatures = &deviceFeatures;
-  createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-  createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+  // optional extensions are enabled when present, the required ones were checked by isDeviceSuitable
+  std::vector<const char *> extensions = deviceExtensions;
+  memoryBudgetSupported_ = isDeviceExtensionSupported(physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+  if (memoryBudgetSupported_) {
+    extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+  }
+
+  createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+  createInfo.ppEnabledExtensionNames = extensions.data();
 
   // might not really be necessary anymore because device specific validation layers
   // have been deprecated
@@ -194,6 +247,18 @@ void LveDevice::createLogicalDevice() {
 
   vkGetDeviceQueue(device_, indices.graphicsFamily, 0, &graphicsQueue_);
   vkGetDeviceQueue(device_, indices.presentFamily, 0, &presentQueue_);
+  vkGetDeviceQueue(device_, transferFamily_, 0, &transferQueue_);
+
+  if (hasDedicatedTransferQueue()) {
+    std::cout << "dedicated transfer queue family: " << transferFamily_ << std::endl;
+  }
+}
+
+void LveDevice::createAllocator() {
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+  allocator_ = std::make_unique<LveAllocator>(
+      device_, memProperties, properties.limits.bufferImageGranularity);
 }
 
 void LveDevice::createCommandPool() {
@@ -208,6 +273,14 @@ void LveDevice::createCommandPool() {
   if (vkCreateCommandPool(device_, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
     throw std::runtime_error("failed to create command pool!");
   }
+
+  transferCommandPool = commandPool;
+  if (hasDedicatedTransferQueue()) {
+    poolInfo.queueFamilyIndex = transferFamily_;
+    if (vkCreateCommandPool(device_, &poolInfo, nullptr, &transferCommandPool) != VK_SUCCESS) {
+      throw std::runtime_error("failed to create transfer command pool!");
+    }
+  }
 }
 
 void LveDevice::createSurface() { window.createWindowSurface(instance, &surface_); }
@@ -227,7 +300,7 @@ bool LveDevice::isDeviceSuitable(VkPhysicalDevice device) {
   vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
 
   return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-         supportedFeatures.samplerAnisotropy;
+         supportedFeatures.samplerAnisotropy && supportedFeatures.shaderSampledImageArrayDynamicIndexing;
 }
 
 void LveDevice::populateDebugMessengerCreateInfo(
@@ -334,6 +407,21 @@ bool LveDevice::checkDeviceExtensionSupport(VkPhysicalDevice device) {
   return requiredExtensions.empty();
 }
 
+bool LveDevice::isDeviceExtensionSupported(VkPhysicalDevice device, const char *extensionName) {
+  uint32_t extensionCount;
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+  std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+  for (const auto &extension : availableExtensions) {
+    if (strcmp(extension.extensionName, extensionName) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 QueueFamilyIndices LveDevice::findQueueFamilies(VkPhysicalDevice device) {
   QueueFamilyIndices indices;
 
@@ -362,6 +450,26 @@ QueueFamilyIndices LveDevice::findQueueFamilies(VkPhysicalDevice device) {
     i++;
   }
 
+  // transfer only families are backed by the copy engines, one without compute is preferred over async compute.
+  // uploadToImage copies rows at any offset and block compressed mips can be smaller than a block, so only a family
+  // with a 1x1x1 image transfer granularity can take image uploads, otherwise everything stays on graphics
+  i = 0;
+  for (const auto &queueFamily : queueFamilies) {
+    VkQueueFlags flags = queueFamily.queueFlags;
+    VkExtent3D granularity = queueFamily.minImageTransferGranularity;
+    bool texelGranularity = granularity.width == 1 && granularity.height == 1 && granularity.depth == 1;
+    if (queueFamily.queueCount > 0 && (flags & VK_QUEUE_TRANSFER_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT) &&
+        texelGranularity) {
+      bool pure = !(flags & VK_QUEUE_COMPUTE_BIT);
+      if (!indices.transferFamilyHasValue ||
+          (pure && (queueFamilies[indices.transferFamily].queueFlags & VK_QUEUE_COMPUTE_BIT))) {
+        indices.transferFamily = i;
+        indices.transferFamilyHasValue = true;
+      }
+    }
+    i++;
+  }
+
   return indices;
 }
 
@@ -408,16 +516,7 @@ VkFormat LveDevice::findSupportedFormat(
 }
 
 uint32_t LveDevice::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-  VkPhysicalDeviceMemoryProperties memProperties;
-  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
-  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-    if ((typeFilter & (1 << i)) &&
-        (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-      return i;
-    }
-  }
-
-  throw std::runtime_error("failed to find suitable memory type!");
+  return allocator_->findMemoryType(typeFilter, properties);
 }
 
 void LveDevice::createBuffer(
@@ -425,7 +524,8 @@ void LveDevice::createBuffer(
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer &buffer,
-    VkDeviceMemory &bufferMemory) {
+    LveAllocator::Allocation &bufferMemory,
+    VkMemoryPropertyFlags preferredProperties) {
   VkBufferCreateInfo bufferInfo{};
   bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
   bufferInfo.size = size;
@@ -439,16 +539,18 @@ void LveDevice::createBuffer(
   VkMemoryRequirements memRequirements;
   vkGetBufferMemoryRequirements(device_, buffer, &memRequirements);
 
-  VkMemoryAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocInfo.allocationSize = memRequirements.size;
-  allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-  if (vkAllocateMemory(device_, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
-    throw std::runtime_error("failed to allocate vertex buffer memory!");
-  }
+  bufferMemory = allocator_->allocate(
+      memRequirements,
+      properties,
+      LveAllocator::ResourceKind::Linear,
+      preferredProperties,
+      bufferCategory(usage));
+  vkBindBufferMemory(device_, buffer, bufferMemory.memory, bufferMemory.offset);
+}
 
-  vkBindBufferMemory(device_, buffer, bufferMemory, 0);
+void LveDevice::destroyBuffer(VkBuffer buffer, LveAllocator::Allocation &bufferMemory) {
+  vkDestroyBuffer(device_, buffer, nullptr);
+  allocator_->free(bufferMemory);
 }
 
 VkCommandBuffer LveDevice::beginSingleTimeCommands() {
@@ -477,18 +579,28 @@ void LveDevice::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = &commandBuffer;
 
-  vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(graphicsQueue_);
+  // waits for this submission only, not for frames or staging batches queued before it
+  VkFenceCreateInfo fenceInfo{};
+  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  VkFence fence;
+  if (vkCreateFence(device_, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create single time command fence!");
+  }
 
+  vkQueueSubmit(graphicsQueue_, 1, &submitInfo, fence);
+  vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX);
+
+  vkDestroyFence(device_, fence, nullptr);
   vkFreeCommandBuffers(device_, commandPool, 1, &commandBuffer);
 }
 
-void LveDevice::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
+void LveDevice::copyBuffer(
+    VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset, VkDeviceSize dstOffset) {
   VkCommandBuffer commandBuffer = beginSingleTimeCommands();
 
   VkBufferCopy copyRegion{};
-  copyRegion.srcOffset = 0;  // Optional
-  copyRegion.dstOffset = 0;  // Optional
+  copyRegion.srcOffset = srcOffset;
+  copyRegion.dstOffset = dstOffset;
   copyRegion.size = size;
   vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
 
@@ -526,7 +638,7 @@ void LveDevice::createImageWithInfo(
     const VkImageCreateInfo &imageInfo,
     VkMemoryPropertyFlags properties,
     VkImage &image,
-    VkDeviceMemory &imageMemory) {
+    LveAllocator::Allocation &imageMemory) {
   if (vkCreateImage(device_, &imageInfo, nullptr, &image) != VK_SUCCESS) {
     throw std::runtime_error("failed to create image!");
   }
@@ -534,17 +646,84 @@ void LveDevice::createImageWithInfo(
   VkMemoryRequirements memRequirements;
   vkGetImageMemoryRequirements(device_, image, &memRequirements);
 
-  VkMemoryAllocateInfo allocInfo{};
-  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocInfo.allocationSize = memRequirements.size;
-  allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
+  LveAllocator::ResourceKind kind = imageInfo.tiling == VK_IMAGE_TILING_OPTIMAL
+      ? LveAllocator::ResourceKind::Optimal
+      : LveAllocator::ResourceKind::Linear;
+  imageMemory = allocator_->allocate(memRequirements, properties, kind, 0, imageCategory(imageInfo.usage));
 
-  if (vkAllocateMemory(device_, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
-    throw std::runtime_error("failed to allocate image memory!");
+  if (vkBindImageMemory(device_, image, imageMemory.memory, imageMemory.offset) != VK_SUCCESS) {
+    throw std::runtime_error("failed to bind image memory!");
   }
+}
 
-  if (vkBindImageMemory(device_, image, imageMemory, 0) != VK_SUCCESS) {
-    throw std::runtime_error("failed to bind image memory!");
+void LveDevice::destroyImage(VkImage image, LveAllocator::Allocation &imageMemory) {
+  vkDestroyImage(device_, image, nullptr);
+  allocator_->free(imageMemory);
+}
+
+std::vector<MemoryHeapSnapshot> LveDevice::getMemorySnapshot() {
+  std::vector<LveAllocator::HeapStats> heapStats = allocator_->getHeapStats();
+
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+  budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+  if (memoryBudgetSupported_) {
+    VkPhysicalDeviceMemoryProperties2 memoryProperties{};
+    memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    memoryProperties.pNext = &budgetProperties;
+    vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &memoryProperties);
+  }
+
+  std::vector<MemoryHeapSnapshot> snapshot(heapStats.size());
+  for (size_t i = 0; i < heapStats.size(); i++) {
+    snapshot[i].engine = heapStats[i];
+    snapshot[i].budget = budgetProperties.heapBudget[i];
+    snapshot[i].processUsage = budgetProperties.heapUsage[i];
+  }
+  return snapshot;
+}
+
+void LveDevice::logMemoryUsage() {
+  constexpr double MB = 1024.0 * 1024.0;
+
+  std::ostringstream line;
+  line << std::fixed << std::setprecision(1) << "memory:";
+  std::vector<std::string> warnings;
+
+  std::vector<MemoryHeapSnapshot> snapshot = getMemorySnapshot();
+  for (size_t i = 0; i < snapshot.size(); i++) {
+    const MemoryHeapSnapshot &heap = snapshot[i];
+    if (heap.engine.bytesReserved == 0) {
+      continue;
+    }
+
+    // without the extension the engine's own reservations against the heap size are the best guess
+    VkDeviceSize used = memoryBudgetSupported_ ? heap.processUsage : heap.engine.bytesReserved;
+    VkDeviceSize limit = memoryBudgetSupported_ ? heap.budget : heap.engine.size;
+
+    line << " heap " << i
+         << ((heap.engine.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? " (device local) " : " (host) ")
+         << used / MB << "/" << limit / MB << " MB [";
+    bool first = true;
+    for (uint32_t category = 0; category < LveAllocator::CATEGORY_COUNT; category++) {
+      if (heap.engine.categoryBytes[category] == 0) {
+        continue;
+      }
+      line << (first ? "" : ", ")
+           << LveAllocator::getCategoryName(static_cast<LveAllocator::Category>(category)) << " "
+           << heap.engine.categoryBytes[category] / MB;
+      first = false;
+    }
+    line << "]";
+
+    if (limit > 0 && used > limit * MEMORY_WARNING_RATIO) {
+      warnings.push_back("heap " + std::to_string(i));
+    }
+  }
+
+  std::cout << line.str() << std::endl;
+  for (const auto &heap : warnings) {
+    std::cout << "warning: " << heap << " is over " << MEMORY_WARNING_RATIO * 100
+              << "% of its memory budget, the driver may start paging" << std::endl;
   }
 }
 
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "lve_window.hpp"
+#include "lve_allocator.hpp"
 
 // std lib headers
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace lve {
 
+class LveStagingRing;
+
 struct SwapChainSupportDetails {
   VkSurfaceCapabilitiesKHR capabilities;
   std::vector<VkSurfaceFormatKHR> formats;
@@ -17,11 +21,20 @@ struct SwapChainSupportDetails {
 struct QueueFamilyIndices {
   uint32_t graphicsFamily;
   uint32_t presentFamily;
+  uint32_t transferFamily;
   bool graphicsFamilyHasValue = false;
   bool presentFamilyHasValue = false;
+  // only set for a family without graphics support, uploads use the graphics family otherwise
+  bool transferFamilyHasValue = false;
   bool isComplete() { return graphicsFamilyHasValue && presentFamilyHasValue; }
 };
 
+struct MemoryHeapSnapshot {
+  LveAllocator::HeapStats engine;  // what the allocator holds on the heap
+  VkDeviceSize budget = 0;         // from VK_EXT_memory_budget, 0 without it
+  VkDeviceSize processUsage = 0;   // everything this process has on the heap according to the driver
+};
+
 class LveDevice {
  public:
 #ifdef NDEBUG
@@ -40,10 +53,19 @@ class LveDevice {
   LveDevice &operator=(LveDevice &&) = delete;
 
   VkCommandPool getCommandPool() { return commandPool; }
+  // command buffers for transferQueue(), the graphics pool when there is no dedicated transfer queue
+  VkCommandPool getTransferCommandPool() { return transferCommandPool; }
   VkDevice device() { return device_; }
   VkSurfaceKHR surface() { return surface_; }
   VkQueue graphicsQueue() { return graphicsQueue_; }
   VkQueue presentQueue() { return presentQueue_; }
+  // a transfer only queue family when the device has one, so uploads run beside rendering
+  VkQueue transferQueue() { return transferQueue_; }
+  uint32_t graphicsQueueFamily() { return graphicsFamily_; }
+  uint32_t transferQueueFamily() { return transferFamily_; }
+  bool hasDedicatedTransferQueue() { return transferFamily_ != graphicsFamily_; }
+  LveAllocator &allocator() { return *allocator_; }
+  LveStagingRing &stagingRing() { return *stagingRing_; }
   void property(VkPhysicalDeviceProperties& properties)
   {
       vkGetPhysicalDeviceProperties(physicalDevice, &properties);
@@ -57,6 +79,12 @@ class LveDevice {
   QueueFamilyIndices findPhysicalQueueFamilies() { return findQueueFamilies(physicalDevice); }
   VkFormat findSupportedFormat(
       const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
+  VkFormatProperties getFormatProperties(VkFormat format) {
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+    return props;
+  }
+  bool hasTextureCompressionBC() { return textureCompressionBCSupported_; }
 
   // Buffer Helper Functions
   void createBuffer(
@@ -64,10 +92,13 @@ class LveDevice {
       VkBufferUsageFlags usage,
       VkMemoryPropertyFlags properties,
       VkBuffer &buffer,
-      VkDeviceMemory &bufferMemory);
+      LveAllocator::Allocation &bufferMemory,
+      VkMemoryPropertyFlags preferredProperties = 0);
+  void destroyBuffer(VkBuffer buffer, LveAllocator::Allocation &bufferMemory);
   VkCommandBuffer beginSingleTimeCommands();
   void endSingleTimeCommands(VkCommandBuffer commandBuffer);
-  void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+  void copyBuffer(
+      VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
   void copyBufferToImage(
       VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount);
 
@@ -75,10 +106,18 @@ class LveDevice {
       const VkImageCreateInfo &imageInfo,
       VkMemoryPropertyFlags properties,
       VkImage &image,
-      VkDeviceMemory &imageMemory);
+      LveAllocator::Allocation &imageMemory);
+  void destroyImage(VkImage image, LveAllocator::Allocation &imageMemory);
 
   VkSampleCountFlagBits getMaxUsableSampleCount();
 
+  // Memory reporting
+  bool hasMemoryBudget() { return memoryBudgetSupported_; }
+  std::vector<MemoryHeapSnapshot> getMemorySnapshot();
+  // one line for the heaps in use, with a warning for any heap past MEMORY_WARNING_RATIO of its budget
+  void logMemoryUsage();
+  static constexpr double MEMORY_WARNING_RATIO = 0.9;
+
   VkPhysicalDeviceProperties properties;
 
  private:
@@ -87,6 +126,7 @@ class LveDevice {
   void createSurface();
   void pickPhysicalDevice();
   void createLogicalDevice();
+  void createAllocator();
   void createCommandPool();
 
   // helper functions
@@ -97,6 +137,7 @@ class LveDevice {
   void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo);
   void hasGflwRequiredInstanceExtensions();
   bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+  bool isDeviceExtensionSupported(VkPhysicalDevice device, const char *extensionName);
   SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
 
   VkInstance instance;
@@ -104,12 +145,20 @@ class LveDevice {
   VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
   LveWindow &window;
   VkCommandPool commandPool;
+  VkCommandPool transferCommandPool;
   
 
   VkDevice device_;
   VkSurfaceKHR surface_;
   VkQueue graphicsQueue_;
   VkQueue presentQueue_;
+  VkQueue transferQueue_;
+  uint32_t graphicsFamily_;
+  uint32_t transferFamily_;
+  bool memoryBudgetSupported_ = false;
+  bool textureCompressionBCSupported_ = false;
+  std::unique_ptr<LveAllocator> allocator_;
+  std::unique_ptr<LveStagingRing> stagingRing_;
 
   const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
   const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
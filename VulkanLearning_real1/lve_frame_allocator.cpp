@@ -0,0 +1,67 @@
+#include "lve_frame_allocator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace lve
+{
+	LveFrameAllocator::LveFrameAllocator(LveDevice& device, uint32_t frameCount, VkDeviceSize frameSize)
+		: lveDevice{ device }, frameCount{ frameCount }
+	{
+		const VkPhysicalDeviceLimits& limits = lveDevice.properties.limits;
+		alignment = std::max(limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment);
+
+		//every region starts aligned, so offsets inside it only need aligning relative to its start
+		this->frameSize = LveBuffer::getAlignment(frameSize, alignment);
+
+		buffer = std::make_unique<LveBuffer>(lveDevice, this->frameSize, frameCount,
+			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, 1,
+			//written every frame and read by the GPU right after, BAR memory avoids the PCIe read and coherent memory the flush
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		if (buffer->map() != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to map frame allocator buffer!");
+		}
+	}
+
+	void LveFrameAllocator::beginFrame(uint32_t frameIndex)
+	{
+		assert(frameIndex < frameCount && "Frame index out of range");
+
+		frameBegin = frameSize * frameIndex;
+		head = 0;
+	}
+
+	void LveFrameAllocator::flush()
+	{
+		if (head == 0)
+		{
+			return;
+		}
+		buffer->flush(head, frameBegin);
+	}
+
+	LveFrameAllocator::Allocation LveFrameAllocator::allocate(VkDeviceSize size)
+	{
+		VkDeviceSize alignedSize = LveBuffer::getAlignment(size, alignment);
+		if (head + alignedSize > frameSize)
+		{
+			throw std::runtime_error("frame allocator is out of space!");
+		}
+
+		Allocation allocation{};
+		allocation.offset = frameBegin + head;
+		allocation.size = size;
+		allocation.data = static_cast<char*>(buffer->getMappedMemory()) + allocation.offset;
+
+		head += alignedSize;
+		return allocation;
+	}
+
+	VkDescriptorBufferInfo LveFrameAllocator::descriptorInfo(VkDeviceSize range) const
+	{
+		return VkDescriptorBufferInfo{ buffer->getBuffer(), 0, range };
+	}
+}
\ No newline at end of file
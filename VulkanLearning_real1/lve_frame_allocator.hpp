@@ -0,0 +1,65 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_buffer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace lve
+{
+	// Per frame uniform and storage data, bump allocated from one persistently mapped buffer split into a region per
+	// frame in flight. Chunks are bound with dynamic offsets into the same descriptor, so new per frame data needs no
+	// buffers or descriptor sets of its own. LveRenderer owns it and resets a frame's region in beginFrame(), right
+	// after the swap chain has waited for that frame's fence, and flushes it in endFrame().
+	class LveFrameAllocator
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_FRAME_SIZE = 1ull << 20;
+
+		struct Allocation
+		{
+			void* data = nullptr;
+			VkDeviceSize offset = 0;	//from the start of the buffer, the dynamic offset to bind it with
+			VkDeviceSize size = 0;
+
+			uint32_t dynamicOffset() const { return static_cast<uint32_t>(offset); }
+		};
+
+		LveFrameAllocator(LveDevice& device, uint32_t frameCount, VkDeviceSize frameSize = DEFAULT_FRAME_SIZE);
+
+		LveFrameAllocator(const LveFrameAllocator&) = delete;
+		LveFrameAllocator& operator=(const LveFrameAllocator&) = delete;
+
+		//the GPU must be done with the frame, which the swap chain's fence wait guarantees
+		void beginFrame(uint32_t frameIndex);
+		//makes this frame's writes visible to the device
+		void flush();
+
+		//aligned for both uniform and storage buffer bindings, throws when the frame's region is full
+		Allocation allocate(VkDeviceSize size);
+		template<typename T>
+		Allocation push(const T& value)
+		{
+			Allocation allocation = allocate(sizeof(T));
+			std::memcpy(allocation.data, &value, sizeof(T));
+			return allocation;
+		}
+
+		VkBuffer getBuffer() const { return buffer->getBuffer(); }
+		VkDeviceSize getAlignment() const { return alignment; }
+		//for UNIFORM_BUFFER_DYNAMIC or STORAGE_BUFFER_DYNAMIC descriptors, range is the size bound at each offset
+		VkDescriptorBufferInfo descriptorInfo(VkDeviceSize range) const;
+
+	private:
+		LveDevice& lveDevice;
+		std::unique_ptr<LveBuffer> buffer;
+		VkDeviceSize alignment;
+		VkDeviceSize frameSize;
+		uint32_t frameCount;
+
+		VkDeviceSize frameBegin = 0;
+		VkDeviceSize head = 0;	//bytes used in the current frame's region
+	};
+}
\ No newline at end of file
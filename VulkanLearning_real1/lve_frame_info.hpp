@@ -2,6 +2,7 @@
 
 #include "lve_camera.hpp"
 #include "lve_game_object.hpp"
+#include "lve_frame_allocator.hpp"
 
 #include <vulkan/vulkan.h>
 
@@ -34,5 +35,7 @@ namespace lve
 		LveCamera& camera;
 		VkDescriptorSet globalDescriptorSet;
 		LveGameObject::Map &gameObjects;
+		LveFrameAllocator& frameAllocator;
+		uint32_t globalUboOffset;	//dynamic offset of this frame's GlobalUbo, bound with globalDescriptorSet
 	};
 }
\ No newline at end of file
@@ -51,6 +51,8 @@ namespace lve {
         std::shared_ptr<LveModel> model{};
         glm::vec3 color{};
         TransformComponent transform{};
+        // from LveTextureRegistry::load, 0 is the first texture loaded
+        uint32_t textureIndex = 0;
 
         std::unique_ptr<PointLightComponent> pointLight = nullptr;
 
@@ -0,0 +1,165 @@
+#include "lve_geometry_pool.hpp"
+
+#include <cassert>
+
+namespace lve
+{
+	LveGeometryPool::Arena::Arena(VkDeviceSize capacity) : capacity{ capacity }
+	{
+		freeBlocks.emplace(0, capacity);
+	}
+
+	bool LveGeometryPool::Arena::allocate(VkDeviceSize size, VkDeviceSize alignment, Range& range)
+	{
+		assert(size > 0 && alignment > 0 && "Cannot allocate an empty range");
+
+		for (auto block = freeBlocks.begin(); block != freeBlocks.end(); ++block)
+		{
+			VkDeviceSize blockOffset = block->first;
+			VkDeviceSize blockEnd = block->first + block->second;
+			VkDeviceSize offset = (blockOffset + alignment - 1) / alignment * alignment;
+			if (offset + size > blockEnd)
+			{
+				continue;
+			}
+
+			//the padding in front stays a free block of its own, the rest of the block after the range too
+			freeBlocks.erase(block);
+			if (offset > blockOffset)
+			{
+				freeBlocks.emplace(blockOffset, offset - blockOffset);
+			}
+			if (offset + size < blockEnd)
+			{
+				freeBlocks.emplace(offset + size, blockEnd - (offset + size));
+			}
+
+			range = { offset, size };
+			bytesUsed += size;
+			rangeCount++;
+			return true;
+		}
+		return false;
+	}
+
+	void LveGeometryPool::Arena::free(const Range& range)
+	{
+		auto block = freeBlocks.emplace(range.offset, range.size).first;
+
+		auto next = std::next(block);
+		if (next != freeBlocks.end() && block->first + block->second == next->first)
+		{
+			block->second += next->second;
+			freeBlocks.erase(next);
+		}
+
+		if (block != freeBlocks.begin())
+		{
+			auto previous = std::prev(block);
+			if (previous->first + previous->second == block->first)
+			{
+				previous->second += block->second;
+				freeBlocks.erase(block);
+			}
+		}
+
+		bytesUsed -= range.size;
+		rangeCount--;
+	}
+
+	LveGeometryPool::LveGeometryPool(LveDevice& device, VkDeviceSize vertexCapacity, VkDeviceSize indexCapacity)
+		: lveDevice{ device }, vertexArena{ vertexCapacity }, indexArena{ indexCapacity }
+	{
+		vertexBuffer = std::make_unique<LveBuffer>(lveDevice, vertexCapacity, 1,
+			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		indexBuffer = std::make_unique<LveBuffer>(lveDevice, indexCapacity, 1,
+			VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	}
+
+	LveGeometryPool::~LveGeometryPool()
+	{
+		assert(vertexArena.getRangeCount() == retiredVertices.size() && indexArena.getRangeCount() == retiredIndices.size()
+			&& "Every model must be destroyed before the geometry pool");
+	}
+
+	LveGeometryPool::Range LveGeometryPool::uploadVertices(const void* vertices, VkDeviceSize vertexSize, uint32_t count)
+	{
+		return upload(*vertexBuffer, vertexArena, vertices, vertexSize, count);
+	}
+
+	LveGeometryPool::Range LveGeometryPool::uploadIndices(const void* indices, VkDeviceSize indexSize, uint32_t count)
+	{
+		return upload(*indexBuffer, indexArena, indices, indexSize, count);
+	}
+
+	LveGeometryPool::Range LveGeometryPool::upload(LveBuffer& buffer, Arena& arena, const void* data, VkDeviceSize elementSize, uint32_t count)
+	{
+		Range range{};
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			if (!arena.allocate(elementSize * count, elementSize, range))
+			{
+				//freed ranges may be enough once they are safe to reuse
+				releaseRetired();
+				if (!arena.allocate(elementSize * count, elementSize, range))
+				{
+					return Range{};
+				}
+			}
+		}
+
+		lveDevice.stagingRing().uploadToBuffer(data, range.size, buffer.getBuffer(), range.offset);
+		return range;
+	}
+
+	void LveGeometryPool::freeVertices(const Range& range)
+	{
+		retire(retiredVertices, range);
+	}
+
+	void LveGeometryPool::freeIndices(const Range& range)
+	{
+		retire(retiredIndices, range);
+	}
+
+	void LveGeometryPool::retire(std::deque<RetiredRange>& retired, const Range& range)
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		//frames that drew with the range were submitted before the open batch will be, and the batch and the ones
+		//before it hold any staging writes still headed for the range
+		retired.push_back({ range, lveDevice.stagingRing().getOpenTicket() });
+	}
+
+	void LveGeometryPool::releaseRetired()
+	{
+		LveStagingRing& stagingRing = lveDevice.stagingRing();
+
+		while (!retiredVertices.empty() && stagingRing.isComplete(retiredVertices.front().ticket))
+		{
+			vertexArena.free(retiredVertices.front().range);
+			retiredVertices.pop_front();
+		}
+		while (!retiredIndices.empty() && stagingRing.isComplete(retiredIndices.front().ticket))
+		{
+			indexArena.free(retiredIndices.front().range);
+			retiredIndices.pop_front();
+		}
+	}
+
+	LveGeometryPool::Stats LveGeometryPool::getStats()
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		Stats stats{};
+		stats.vertexCapacity = vertexArena.getCapacity();
+		stats.vertexBytesUsed = vertexArena.getBytesUsed();
+		stats.indexCapacity = indexArena.getCapacity();
+		stats.indexBytesUsed = indexArena.getBytesUsed();
+		stats.ranges = vertexArena.getRangeCount() + indexArena.getRangeCount();
+		return stats;
+	}
+}
\ No newline at end of file
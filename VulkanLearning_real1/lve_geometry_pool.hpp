@@ -0,0 +1,110 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_buffer.hpp"
+#include "lve_staging_ring.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace lve
+{
+	// One device local vertex buffer and one index buffer shared by every model, so a scene binds its geometry once and
+	// the number of device allocations stays at two however many models are loaded. Models own ranges of the two
+	// buffers, handed out first fit from a free list and merged with their free neighbours again when released.
+	class LveGeometryPool
+	{
+	public:
+		static constexpr VkDeviceSize DEFAULT_VERTEX_CAPACITY = 128ull << 20;
+		static constexpr VkDeviceSize DEFAULT_INDEX_CAPACITY = 64ull << 20;
+
+		//byte range of one of the buffers, size 0 means the allocation failed
+		struct Range
+		{
+			VkDeviceSize offset = 0;
+			VkDeviceSize size = 0;
+
+			bool isValid() const { return size > 0; }
+		};
+
+		struct Stats
+		{
+			VkDeviceSize vertexCapacity = 0;
+			VkDeviceSize vertexBytesUsed = 0;
+			VkDeviceSize indexCapacity = 0;
+			VkDeviceSize indexBytesUsed = 0;
+			uint32_t ranges = 0;
+		};
+
+		LveGeometryPool(LveDevice& device, VkDeviceSize vertexCapacity = DEFAULT_VERTEX_CAPACITY,
+			VkDeviceSize indexCapacity = DEFAULT_INDEX_CAPACITY);
+		~LveGeometryPool();
+
+		LveGeometryPool(const LveGeometryPool&) = delete;
+		LveGeometryPool& operator=(const LveGeometryPool&) = delete;
+
+		//uploads count elements and returns their range, or an invalid range when the pool has no room left.
+		//offsets are a multiple of the element size, so offset / size is the vertexOffset / firstIndex to draw with
+		Range uploadVertices(const void* vertices, VkDeviceSize vertexSize, uint32_t count);
+		Range uploadIndices(const void* indices, VkDeviceSize indexSize, uint32_t count);
+
+		//the range is reused once the staging batch open at the time has completed, which is after every frame
+		//submitted so far, so frames still in flight may keep reading it
+		void freeVertices(const Range& range);
+		void freeIndices(const Range& range);
+
+		VkBuffer getVertexBuffer() const { return vertexBuffer->getBuffer(); }
+		VkBuffer getIndexBuffer() const { return indexBuffer->getBuffer(); }
+
+		Stats getStats();
+
+	private:
+		// First fit allocator over [0, capacity), free blocks are kept sorted by offset so neighbours merge on free
+		class Arena
+		{
+		public:
+			Arena(VkDeviceSize capacity);
+
+			//alignment does not have to be a power of two, vertex strides like 44 are fine
+			bool allocate(VkDeviceSize size, VkDeviceSize alignment, Range& range);
+			void free(const Range& range);
+
+			VkDeviceSize getCapacity() const { return capacity; }
+			VkDeviceSize getBytesUsed() const { return bytesUsed; }
+			uint32_t getRangeCount() const { return rangeCount; }
+
+		private:
+			std::map<VkDeviceSize, VkDeviceSize> freeBlocks;	//offset -> size
+			VkDeviceSize capacity;
+			VkDeviceSize bytesUsed = 0;
+			uint32_t rangeCount = 0;
+		};
+
+		//a freed range and the staging ticket that has to complete before it can be handed out again
+		struct RetiredRange
+		{
+			Range range;
+			LveStagingRing::Ticket ticket;
+		};
+
+		Range upload(LveBuffer& buffer, Arena& arena, const void* data, VkDeviceSize elementSize, uint32_t count);
+		void retire(std::deque<RetiredRange>& retired, const Range& range);
+		//frees the retired ranges whose ticket has completed, never waits
+		void releaseRetired();
+
+		LveDevice& lveDevice;
+
+		std::unique_ptr<LveBuffer> vertexBuffer;
+		std::unique_ptr<LveBuffer> indexBuffer;
+
+		std::mutex mutex;
+		Arena vertexArena;
+		Arena indexArena;
+		std::deque<RetiredRange> retiredVertices;	//in ticket order
+		std::deque<RetiredRange> retiredIndices;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "lve_mapped_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lve
+{
+	//a missing or empty file leaves the mapping closed instead of throwing, callers check isOpen()
+	LveMappedFile::LveMappedFile(const std::string& filepath)
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+		fileHandle = file;
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			close();
+			return;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			close();
+			return;
+		}
+		mappingHandle = mapping;
+
+		data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr)
+		{
+			close();
+			return;
+		}
+		size = static_cast<size_t>(fileSize.QuadPart);
+#else
+		fileDescriptor = open(filepath.c_str(), O_RDONLY);
+		if (fileDescriptor < 0)
+		{
+			return;
+		}
+
+		struct stat fileStat{};
+		if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			close();
+			return;
+		}
+
+		void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (view == MAP_FAILED)
+		{
+			close();
+			return;
+		}
+		data = static_cast<const char*>(view);
+		size = static_cast<size_t>(fileStat.st_size);
+#endif
+	}
+
+	LveMappedFile::~LveMappedFile()
+	{
+		close();
+	}
+
+	void LveMappedFile::close()
+	{
+#ifdef _WIN32
+		if (data != nullptr)
+		{
+			UnmapViewOfFile(data);
+		}
+		if (mappingHandle != nullptr)
+		{
+			CloseHandle(mappingHandle);
+		}
+		if (fileHandle != nullptr)
+		{
+			CloseHandle(fileHandle);
+		}
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+#else
+		if (data != nullptr)
+		{
+			munmap(const_cast<char*>(data), size);
+		}
+		if (fileDescriptor >= 0)
+		{
+			::close(fileDescriptor);
+		}
+		fileDescriptor = -1;
+#endif
+		data = nullptr;
+		size = 0;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace lve
+{
+	// Read-only memory mapping of a whole file, the view is released on destruction
+	class LveMappedFile
+	{
+	public:
+		LveMappedFile(const std::string& filepath);
+		~LveMappedFile();
+
+		LveMappedFile(const LveMappedFile&) = delete;
+		LveMappedFile& operator=(const LveMappedFile&) = delete;
+
+		bool isOpen() const { return data != nullptr; }
+		const char* getData() const { return data; }
+		size_t getSize() const { return size; }
+
+	private:
+		void close();
+
+		const char* data = nullptr;
+		size_t size = 0;
+
+#ifdef _WIN32
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+#else
+		int fileDescriptor = -1;
+#endif
+	};
+}
@@ -0,0 +1,190 @@
+#include "lve_mesh_cache.hpp"
+#include "lve_mapped_file.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+namespace lve
+{
+	static_assert(std::is_trivially_copyable_v<LveModel::Vertex> && std::is_trivially_copyable_v<LveModel::PackedVertex> &&
+		std::is_trivially_copyable_v<LveModel::Lod> && std::is_trivially_copyable_v<Meshlet> &&
+		std::is_trivially_copyable_v<MeshletBounds>, "Builder arrays are written to the mesh cache as raw bytes");
+	static_assert(sizeof(LveMeshCacheHeader) == 112, "Mesh cache header layout changed, bump LveMeshCache::VERSION");
+
+	static bool querySourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& writeTime)
+	{
+		std::error_code error;
+		size = std::filesystem::file_size(sourcePath, error);
+		if (error)
+		{
+			return false;
+		}
+
+		auto time = std::filesystem::last_write_time(sourcePath, error);
+		if (error)
+		{
+			return false;
+		}
+		writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+		return true;
+	}
+
+	//the registry can import one source with different options on several workers at once, so every write gets
+	//its own temporary. The random part keeps two running instances of the app apart
+	static std::string uniqueTempPath(const std::string& cachePath)
+	{
+		static const uint32_t processTag = std::random_device{}();
+		static std::atomic<uint32_t> writeCount{ 0 };
+		return cachePath + '.' + std::to_string(processTag) + '.' + std::to_string(writeCount++) + ".tmp";
+	}
+
+	template <typename T>
+	static size_t byteSize(const std::vector<T>& values)
+	{
+		return values.size() * sizeof(T);
+	}
+
+	template <typename T>
+	static void writeArray(std::ofstream& file, const std::vector<T>& values)
+	{
+		file.write(reinterpret_cast<const char*>(values.data()), byteSize(values));
+	}
+
+	//copies count elements out of the blob and returns the position after them
+	template <typename T>
+	static const char* readArray(const char* blob, uint32_t count, std::vector<T>& values)
+	{
+		values.resize(count);
+		std::memcpy(values.data(), blob, byteSize(values));
+		return blob + byteSize(values);
+	}
+
+	std::string LveMeshCache::cachePathFor(const std::string& sourcePath, const ModelImportOptions& options)
+	{
+		std::ostringstream path;
+		path << sourcePath << '.' << std::hex << static_cast<uint64_t>(options.hash()) << ".lvemesh";
+		return path.str();
+	}
+
+	bool LveMeshCache::read(const std::string& sourcePath, const ModelImportOptions& options, LveModel::Builder& builder)
+	{
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		if (!querySourceStamp(sourcePath, sourceSize, sourceWriteTime))
+		{
+			return false;
+		}
+
+		LveMappedFile file{ cachePathFor(sourcePath, options) };
+		if (!file.isOpen() || file.getSize() < sizeof(LveMeshCacheHeader))
+		{
+			return false;
+		}
+
+		LveMeshCacheHeader header;
+		std::memcpy(&header, file.getData(), sizeof(header));
+
+		if (header.magic != MAGIC || header.version != VERSION || header.vertexStride != sizeof(LveModel::Vertex) ||
+			header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime ||
+			header.optionsHash != static_cast<uint64_t>(options.hash()))
+		{
+			return false;
+		}
+
+		uint64_t expectedSize = sizeof(LveMeshCacheHeader) +
+			static_cast<uint64_t>(header.vertexCount) * sizeof(LveModel::Vertex) +
+			static_cast<uint64_t>(header.packedVertexCount) * sizeof(LveModel::PackedVertex) +
+			static_cast<uint64_t>(header.indexCount) * sizeof(uint32_t) +
+			static_cast<uint64_t>(header.lodCount) * sizeof(LveModel::Lod) +
+			static_cast<uint64_t>(header.meshletCount) * (sizeof(Meshlet) + sizeof(MeshletBounds)) +
+			static_cast<uint64_t>(header.meshletVertexCount) * sizeof(uint32_t) +
+			header.meshletTriangleBytes;
+		if (file.getSize() != expectedSize)
+		{
+			return false;
+		}
+
+		const char* blob = file.getData() + sizeof(LveMeshCacheHeader);
+		blob = readArray(blob, header.vertexCount, builder.vertices);
+		blob = readArray(blob, header.packedVertexCount, builder.packedVertices);
+		blob = readArray(blob, header.indexCount, builder.indices);
+		blob = readArray(blob, header.lodCount, builder.lods);
+		blob = readArray(blob, header.meshletCount, builder.meshlets.meshlets);
+		blob = readArray(blob, header.meshletCount, builder.meshlets.bounds);
+		blob = readArray(blob, header.meshletVertexCount, builder.meshlets.vertices);
+		readArray(blob, header.meshletTriangleBytes, builder.meshlets.triangles);
+
+		builder.vertexFormat = static_cast<VertexFormat>(header.vertexFormat);
+		builder.boundsMin = { header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] };
+		builder.boundsMax = { header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] };
+		builder.cacheStatsBefore = header.cacheStatsBefore;
+		builder.cacheStatsAfter = header.cacheStatsAfter;
+		return true;
+	}
+
+	void LveMeshCache::write(const std::string& sourcePath, const ModelImportOptions& options, const LveModel::Builder& builder)
+	{
+		LveMeshCacheHeader header{};
+		header.magic = MAGIC;
+		header.version = VERSION;
+		if (!querySourceStamp(sourcePath, header.sourceSize, header.sourceWriteTime))
+		{
+			return;
+		}
+		header.optionsHash = static_cast<uint64_t>(options.hash());
+		header.vertexFormat = static_cast<uint32_t>(builder.vertexFormat);
+		header.vertexStride = sizeof(LveModel::Vertex);
+		header.vertexCount = static_cast<uint32_t>(builder.vertices.size());
+		header.packedVertexCount = static_cast<uint32_t>(builder.packedVertices.size());
+		header.indexCount = static_cast<uint32_t>(builder.indices.size());
+		header.lodCount = static_cast<uint32_t>(builder.lods.size());
+		header.meshletCount = static_cast<uint32_t>(builder.meshlets.meshlets.size());
+		header.meshletVertexCount = static_cast<uint32_t>(builder.meshlets.vertices.size());
+		header.meshletTriangleBytes = static_cast<uint32_t>(builder.meshlets.triangles.size());
+		for (int i = 0; i < 3; i++)
+		{
+			header.boundsMin[i] = builder.boundsMin[i];
+			header.boundsMax[i] = builder.boundsMax[i];
+		}
+		header.cacheStatsBefore = builder.cacheStatsBefore;
+		header.cacheStatsAfter = builder.cacheStatsAfter;
+
+		//written under a temporary name first so an interrupted write never leaves a valid looking cache behind
+		std::string cachePath = cachePathFor(sourcePath, options);
+		std::string tempPath = uniqueTempPath(cachePath);
+		bool written = false;
+		{
+			std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+			if (file.is_open())
+			{
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				writeArray(file, builder.vertices);
+				writeArray(file, builder.packedVertices);
+				writeArray(file, builder.indices);
+				writeArray(file, builder.lods);
+				writeArray(file, builder.meshlets.meshlets);
+				writeArray(file, builder.meshlets.bounds);
+				writeArray(file, builder.meshlets.vertices);
+				writeArray(file, builder.meshlets.triangles);
+				written = file.good();
+			}
+		}
+
+		std::error_code error;
+		if (written)
+		{
+			std::filesystem::rename(tempPath, cachePath, error);
+		}
+		if (!written || error)
+		{
+			std::cout << "Could not write mesh cache: " << cachePath << '\n';
+			std::filesystem::remove(tempPath, error);
+		}
+	}
+}
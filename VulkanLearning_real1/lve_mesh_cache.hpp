@@ -0,0 +1,50 @@
+#pragma once
+
+#include "lve_model.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace lve
+{
+	// Binary file written next to an imported OBJ, laid out as header | vertices | packed vertices | indices | lods |
+	// meshlets | meshlet bounds | meshlet vertices | meshlet triangles. It holds the builder after every step the
+	// import options asked for, so a hit skips the import and all of the processing
+	struct LveMeshCacheHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sourceSize;		//the cache is stale as soon as either of these stop matching the source file
+		int64_t sourceWriteTime;
+		uint64_t optionsHash;		//ModelImportOptions::hash() of the options the builder was processed with
+		uint32_t vertexFormat;
+		uint32_t vertexStride;
+		uint32_t vertexCount;
+		uint32_t packedVertexCount;
+		uint32_t indexCount;
+		uint32_t lodCount;
+		uint32_t meshletCount;
+		uint32_t meshletVertexCount;
+		uint32_t meshletTriangleBytes;
+		uint32_t reserved;
+		float boundsMin[3];
+		float boundsMax[3];
+		VertexCacheStats cacheStatsBefore;
+		VertexCacheStats cacheStatsAfter;
+	};
+
+	class LveMeshCache
+	{
+	public:
+		static constexpr uint32_t MAGIC = 0x4d45564c; //"LVEM"
+		static constexpr uint32_t VERSION = 3;
+
+		//one file per source and set of options, so loading a model with different options doesn't evict another
+		static std::string cachePathFor(const std::string& sourcePath, const ModelImportOptions& options);
+
+		//returns false when there is no cache for the source and options or it is stale, builder is left untouched
+		//in that case
+		static bool read(const std::string& sourcePath, const ModelImportOptions& options, LveModel::Builder& builder);
+		static void write(const std::string& sourcePath, const ModelImportOptions& options, const LveModel::Builder& builder);
+	};
+}
\ No newline at end of file
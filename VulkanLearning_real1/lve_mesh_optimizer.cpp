@@ -0,0 +1,357 @@
+#include "lve_mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+namespace lve
+{
+	//scoring constants from Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+	static constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+	static constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+	static constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+	static constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.f;
+	static constexpr float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+	static constexpr uint32_t NO_TRIANGLE = UINT32_MAX;
+
+	static float forsythVertexScore(int cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+		{
+			return -1.f;
+		}
+
+		float score = 0.f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				//the triangle just drawn, scored lower so the next one does not reuse all three vertices
+				score = FORSYTH_LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				float scaler = 1.f / (FORSYTH_CACHE_SIZE - 3);
+				score = std::pow(1.f - (cachePosition - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+			}
+		}
+
+		//vertices with few triangles left get a boost so they are finished off instead of left as stragglers
+		score += FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -FORSYTH_VALENCE_BOOST_POWER);
+		return score;
+	}
+
+	//FIFO cache where an entry is live while fewer than cacheSize misses happened since it was loaded
+	class FifoCache
+	{
+	public:
+		FifoCache(size_t vertexCount, uint32_t cacheSize) : timestamps(vertexCount, 0), cacheSize{ cacheSize }, time{ cacheSize + 1 } {}
+
+		bool access(uint32_t index)
+		{
+			if (time - timestamps[index] > cacheSize)
+			{
+				timestamps[index] = time++;
+				return true;
+			}
+			return false;
+		}
+
+		void reset() { time += cacheSize + 1; }
+
+	private:
+		std::vector<uint32_t> timestamps;
+		uint32_t cacheSize;
+		uint32_t time;
+	};
+
+	void LveMeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+	{
+		assert(indices.size() % 3 == 0 && "Index count must be a multiple of 3");
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		//triangles per vertex, the live part of each list shrinks as triangles are emitted
+		std::vector<uint32_t> liveTriangles(vertexCount, 0);
+		for (uint32_t index : indices)
+		{
+			liveTriangles[index]++;
+		}
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+		}
+
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		std::vector<float> vertexScores(vertexCount);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			vertexScores[v] = forsythVertexScore(-1, liveTriangles[v]);
+		}
+
+		std::vector<float> triangleScores(triangleCount);
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			triangleScores[t] = vertexScores[indices[t * 3 + 0]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		}
+
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32_t> output;
+		output.reserve(indices.size());
+
+		std::vector<uint32_t> cache;
+		std::vector<uint32_t> nextCache;
+		cache.reserve(FORSYTH_CACHE_SIZE + 3);
+		nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+		uint32_t bestTriangle = static_cast<uint32_t>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+		size_t inputCursor = 0;
+
+		while (output.size() < indices.size())
+		{
+			if (bestTriangle == NO_TRIANGLE)
+			{
+				//nothing in the cache touches a live triangle, continue with the next one in input order
+				while (emitted[inputCursor]) inputCursor++;
+				bestTriangle = static_cast<uint32_t>(inputCursor);
+			}
+
+			const uint32_t* corners = &indices[bestTriangle * 3];
+			emitted[bestTriangle] = true;
+			output.insert(output.end(), corners, corners + 3);
+
+			nextCache.assign(corners, corners + 3);
+			for (uint32_t v : cache)
+			{
+				if (v != corners[0] && v != corners[1] && v != corners[2])
+				{
+					nextCache.push_back(v);
+				}
+			}
+
+			for (int c = 0; c < 3; c++)
+			{
+				uint32_t v = corners[c];
+				uint32_t* begin = &adjacency[adjacencyOffsets[v]];
+				uint32_t* end = begin + liveTriangles[v];
+				*std::find(begin, end, bestTriangle) = *(end - 1);
+				liveTriangles[v]--;
+			}
+
+			//rescore everything that was in the cache, including vertices that just dropped out of it
+			for (size_t i = 0; i < nextCache.size(); i++)
+			{
+				uint32_t v = nextCache[i];
+				int cachePosition = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+				float score = forsythVertexScore(cachePosition, liveTriangles[v]);
+				float delta = score - vertexScores[v];
+				vertexScores[v] = score;
+
+				for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + liveTriangles[v]; a++)
+				{
+					triangleScores[adjacency[a]] += delta;
+				}
+			}
+
+			if (nextCache.size() > FORSYTH_CACHE_SIZE)
+			{
+				nextCache.resize(FORSYTH_CACHE_SIZE);
+			}
+			cache.swap(nextCache);
+
+			//only triangles touching the cache changed score, the best of those is drawn next
+			bestTriangle = NO_TRIANGLE;
+			float bestScore = -1.f;
+			for (uint32_t v : cache)
+			{
+				for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + liveTriangles[v]; a++)
+				{
+					uint32_t t = adjacency[a];
+					if (triangleScores[t] > bestScore)
+					{
+						bestScore = triangleScores[t];
+						bestTriangle = t;
+					}
+				}
+			}
+		}
+
+		indices.swap(output);
+	}
+
+	void LveMeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<LveModel::Vertex>& vertices, float threshold)
+	{
+		assert(indices.size() % 3 == 0 && "Index count must be a multiple of 3");
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		//hard boundaries, where the cache was flushed anyway because a triangle missed on all three vertices
+		std::vector<size_t> hardClusters;
+		{
+			FifoCache cache{ vertices.size(), DEFAULT_CACHE_SIZE };
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				int misses = cache.access(indices[t * 3 + 0]) + cache.access(indices[t * 3 + 1]) + cache.access(indices[t * 3 + 2]);
+				if (t == 0 || misses == 3)
+				{
+					hardClusters.push_back(t);
+				}
+			}
+		}
+		hardClusters.push_back(triangleCount);
+
+		//soft boundaries, split a hard cluster wherever restarting with a cold cache keeps ACMR under the threshold
+		std::vector<size_t> clusters;
+		{
+			FifoCache cache{ vertices.size(), DEFAULT_CACHE_SIZE };
+			for (size_t h = 0; h + 1 < hardClusters.size(); h++)
+			{
+				size_t begin = hardClusters[h];
+				size_t end = hardClusters[h + 1];
+
+				cache.reset();
+				size_t clusterMisses = 0;
+				for (size_t t = begin; t < end; t++)
+				{
+					clusterMisses += cache.access(indices[t * 3 + 0]) + cache.access(indices[t * 3 + 1]) + cache.access(indices[t * 3 + 2]);
+				}
+				float targetAcmr = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+				clusters.push_back(begin);
+				cache.reset();
+				size_t segmentStart = begin;
+				size_t segmentMisses = 0;
+				for (size_t t = begin; t < end; t++)
+				{
+					segmentMisses += cache.access(indices[t * 3 + 0]) + cache.access(indices[t * 3 + 1]) + cache.access(indices[t * 3 + 2]);
+					if (t + 1 < end && static_cast<float>(segmentMisses) <= targetAcmr * static_cast<float>(t + 1 - segmentStart))
+					{
+						clusters.push_back(t + 1);
+						cache.reset();
+						segmentStart = t + 1;
+						segmentMisses = 0;
+					}
+				}
+			}
+		}
+		clusters.push_back(triangleCount);
+		size_t clusterCount = clusters.size() - 1;
+
+		//area weighted centroid of the whole mesh, and of each cluster together with its area weighted normal
+		std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3{ 0.f });
+		std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3{ 0.f });
+		glm::vec3 meshCentroid{ 0.f };
+		float meshArea = 0.f;
+
+		for (size_t c = 0; c < clusterCount; c++)
+		{
+			float clusterArea = 0.f;
+			for (size_t t = clusters[c]; t < clusters[c + 1]; t++)
+			{
+				const glm::vec3& p0 = vertices[indices[t * 3 + 0]].position;
+				const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+				const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+
+				glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+				float area = glm::length(normal);
+				glm::vec3 center = (p0 + p1 + p2) / 3.f;
+
+				clusterCentroids[c] += center * area;
+				clusterNormals[c] += normal;
+				clusterArea += area;
+			}
+
+			meshCentroid += clusterCentroids[c];
+			meshArea += clusterArea;
+			clusterCentroids[c] = clusterArea > 0.f ? clusterCentroids[c] / clusterArea : glm::vec3{ 0.f };
+		}
+		meshCentroid = meshArea > 0.f ? meshCentroid / meshArea : glm::vec3{ 0.f };
+
+		//clusters facing away from the centre tend to occlude the rest, so they go first. The summed normal grows with
+		//the cluster's area, only its direction may count
+		std::vector<float> sortKeys(clusterCount);
+		for (size_t c = 0; c < clusterCount; c++)
+		{
+			float length = glm::length(clusterNormals[c]);
+			glm::vec3 direction = length > 0.f ? clusterNormals[c] / length : glm::vec3{ 0.f };
+			sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, direction);
+		}
+
+		std::vector<uint32_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<uint32_t> output;
+		output.reserve(indices.size());
+		for (uint32_t c : order)
+		{
+			output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+		}
+		indices.swap(output);
+	}
+
+	void LveMeshOptimizer::optimizeVertexFetch(std::vector<LveModel::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		constexpr uint32_t UNUSED = UINT32_MAX;
+		std::vector<uint32_t> remap(vertices.size(), UNUSED);
+		std::vector<LveModel::Vertex> output;
+		output.reserve(vertices.size());
+
+		for (uint32_t& index : indices)
+		{
+			if (remap[index] == UNUSED)
+			{
+				remap[index] = static_cast<uint32_t>(output.size());
+				output.push_back(vertices[index]);
+			}
+			index = remap[index];
+		}
+
+		vertices.swap(output);
+	}
+
+	LveMeshOptimizer::CacheStats LveMeshOptimizer::analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize)
+	{
+		CacheStats stats{};
+		if (indices.empty())
+		{
+			return stats;
+		}
+
+		FifoCache cache{ vertexCount, cacheSize };
+		std::vector<bool> referenced(vertexCount, false);
+		size_t misses = 0;
+		size_t uniqueVertices = 0;
+
+		for (uint32_t index : indices)
+		{
+			misses += cache.access(index);
+			if (!referenced[index])
+			{
+				referenced[index] = true;
+				uniqueVertices++;
+			}
+		}
+
+		stats.acmr = static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+		stats.atvr = static_cast<float>(misses) / static_cast<float>(uniqueVertices);
+		return stats;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "lve_model.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace lve
+{
+	// Reorders an indexed triangle list for the GPU: vertex cache friendly triangle order, then an overdraw aware
+	// reorder of the resulting clusters, then vertex buffer order matching first use.
+	// Everything runs on the CPU, the cache is modelled as a FIFO like most desktop hardware behaves.
+	class LveMeshOptimizer
+	{
+	public:
+		using CacheStats = VertexCacheStats;
+
+		static constexpr uint32_t DEFAULT_CACHE_SIZE = 16;
+
+		//Forsyth's linear speed vertex cache optimisation
+		static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+		//expects a vertex cache optimised order, splits it into clusters without raising ACMR above threshold times
+		//the input and sorts the clusters so outward facing ones are drawn first
+		static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<LveModel::Vertex>& vertices,
+			float threshold = 1.05f);
+
+		//orders vertices by first use in indices and drops unreferenced ones, indices are rewritten to match
+		static void optimizeVertexFetch(std::vector<LveModel::Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		static CacheStats analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount,
+			uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+	};
+}
\ No newline at end of file
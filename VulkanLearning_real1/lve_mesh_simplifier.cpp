@@ -0,0 +1,353 @@
+#include "lve_mesh_simplifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+
+namespace lve
+{
+	//borders have no opposite face to hold them in place, so they get a steep perpendicular plane instead
+	static constexpr double BORDER_WEIGHT = 10.0;
+
+	struct Quadric
+	{
+		double a2 = 0, ab = 0, ac = 0, ad = 0;
+		double b2 = 0, bc = 0, bd = 0;
+		double c2 = 0, cd = 0;
+		double d2 = 0;
+		double weight = 0;
+
+		static Quadric fromPlane(const glm::dvec3& normal, double distance, double weight)
+		{
+			Quadric q{};
+			q.a2 = normal.x * normal.x * weight; q.ab = normal.x * normal.y * weight; q.ac = normal.x * normal.z * weight; q.ad = normal.x * distance * weight;
+			q.b2 = normal.y * normal.y * weight; q.bc = normal.y * normal.z * weight; q.bd = normal.y * distance * weight;
+			q.c2 = normal.z * normal.z * weight; q.cd = normal.z * distance * weight;
+			q.d2 = distance * distance * weight;
+			q.weight = weight;
+			return q;
+		}
+
+		void add(const Quadric& q)
+		{
+			a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+			b2 += q.b2; bc += q.bc; bd += q.bd;
+			c2 += q.c2; cd += q.cd;
+			d2 += q.d2;
+			weight += q.weight;
+		}
+
+		//weighted mean squared distance of p to the accumulated planes
+		double error(const glm::vec3& p) const
+		{
+			double x = p.x, y = p.y, z = p.z;
+			double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+				+ b2 * y * y + 2 * bc * y * z + 2 * bd * y
+				+ c2 * z * z + 2 * cd * z
+				+ d2;
+			return weight > 0 ? std::abs(e) / weight : 0.0;
+		}
+	};
+
+	struct Collapse
+	{
+		double cost;
+		uint32_t from;
+		uint32_t to;
+		uint32_t fromVersion;
+		uint32_t toVersion;
+
+		bool operator >(const Collapse& other) const { return cost > other.cost; }
+	};
+
+	static float attributeDistance(const LveModel::Vertex& a, const LveModel::Vertex& b)
+	{
+		glm::vec3 normal = a.normal - b.normal;
+		glm::vec3 color = a.color - b.color;
+		glm::vec2 uv = a.uv - b.uv;
+		return glm::dot(normal, normal) + glm::dot(color, color) + glm::dot(uv, uv);
+	}
+
+	static uint64_t edgeKey(uint32_t a, uint32_t b)
+	{
+		return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+	}
+
+	std::vector<LveMeshSimplifier::Level> LveMeshSimplifier::buildLodChain(const std::vector<LveModel::Vertex>& vertices,
+		const std::vector<uint32_t>& indices, const std::vector<float>& maxErrors)
+	{
+		assert(indices.size() % 3 == 0 && "Index count must be a multiple of 3");
+		std::vector<Level> levels;
+		if (indices.empty() || maxErrors.empty())
+		{
+			return levels;
+		}
+
+		//the simplification runs on positions, vertices that only differ in normal/uv/color share one position
+		std::vector<uint32_t> sortedVertices(vertices.size());
+		std::iota(sortedVertices.begin(), sortedVertices.end(), 0);
+		std::sort(sortedVertices.begin(), sortedVertices.end(), [&](uint32_t a, uint32_t b)
+			{
+				const glm::vec3& pa = vertices[a].position;
+				const glm::vec3& pb = vertices[b].position;
+				if (pa.x != pb.x) return pa.x < pb.x;
+				if (pa.y != pb.y) return pa.y < pb.y;
+				return pa.z < pb.z;
+			});
+
+		std::vector<uint32_t> vertexPosition(vertices.size());
+		std::vector<glm::vec3> positions;
+		std::vector<uint32_t> positionVertexOffsets;
+		for (size_t i = 0; i < sortedVertices.size(); i++)
+		{
+			if (i == 0 || vertices[sortedVertices[i]].position != vertices[sortedVertices[i - 1]].position)
+			{
+				positions.push_back(vertices[sortedVertices[i]].position);
+				positionVertexOffsets.push_back(static_cast<uint32_t>(i));
+			}
+			vertexPosition[sortedVertices[i]] = static_cast<uint32_t>(positions.size() - 1);
+		}
+		positionVertexOffsets.push_back(static_cast<uint32_t>(sortedVertices.size()));
+		uint32_t positionCount = static_cast<uint32_t>(positions.size());
+
+		//triangles keep the vertex of each corner, the position is looked up through it
+		std::vector<std::array<uint32_t, 3>> triangles;
+		triangles.reserve(indices.size() / 3);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			uint32_t p0 = vertexPosition[indices[i]], p1 = vertexPosition[indices[i + 1]], p2 = vertexPosition[indices[i + 2]];
+			if (p0 != p1 && p1 != p2 && p0 != p2)
+			{
+				triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+			}
+		}
+
+		std::vector<bool> triangleAlive(triangles.size(), true);
+		size_t aliveTriangles = triangles.size();
+		std::vector<std::vector<uint32_t>> positionTriangles(positionCount);
+		for (uint32_t t = 0; t < triangles.size(); t++)
+		{
+			for (uint32_t v : triangles[t])
+			{
+				positionTriangles[vertexPosition[v]].push_back(t);
+			}
+		}
+
+		std::vector<Quadric> quadrics(positionCount);
+		std::unordered_map<uint64_t, uint32_t> edgeUse;
+		edgeUse.reserve(triangles.size() * 3);
+		for (const auto& triangle : triangles)
+		{
+			const glm::vec3& p0 = positions[vertexPosition[triangle[0]]];
+			const glm::vec3& p1 = positions[vertexPosition[triangle[1]]];
+			const glm::vec3& p2 = positions[vertexPosition[triangle[2]]];
+
+			glm::dvec3 normal = glm::cross(glm::dvec3(p1 - p0), glm::dvec3(p2 - p0));
+			double area = glm::length(normal);
+			if (area == 0.0)
+			{
+				continue;
+			}
+			normal /= area;
+
+			Quadric plane = Quadric::fromPlane(normal, -glm::dot(normal, glm::dvec3(p0)), area);
+			for (uint32_t v : triangle)
+			{
+				quadrics[vertexPosition[v]].add(plane);
+			}
+
+			for (int e = 0; e < 3; e++)
+			{
+				edgeUse[edgeKey(vertexPosition[triangle[e]], vertexPosition[triangle[(e + 1) % 3]])]++;
+			}
+		}
+
+		for (const auto& triangle : triangles)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				uint32_t a = vertexPosition[triangle[e]];
+				uint32_t b = vertexPosition[triangle[(e + 1) % 3]];
+				if (edgeUse[edgeKey(a, b)] != 1)
+				{
+					continue;
+				}
+
+				const glm::vec3& p0 = positions[vertexPosition[triangle[0]]];
+				glm::dvec3 faceNormal = glm::cross(glm::dvec3(positions[vertexPosition[triangle[1]]] - p0),
+					glm::dvec3(positions[vertexPosition[triangle[2]]] - p0));
+				glm::dvec3 edge = glm::dvec3(positions[b] - positions[a]);
+				glm::dvec3 normal = glm::cross(edge, faceNormal);
+				double length = glm::length(normal);
+				if (length == 0.0)
+				{
+					continue;
+				}
+				normal /= length;
+
+				Quadric plane = Quadric::fromPlane(normal, -glm::dot(normal, glm::dvec3(positions[a])), BORDER_WEIGHT * glm::dot(edge, edge));
+				quadrics[a].add(plane);
+				quadrics[b].add(plane);
+			}
+		}
+
+		std::vector<uint32_t> versions(positionCount, 0);
+		std::vector<bool> positionAlive(positionCount, true);
+		std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+
+		auto pushEdge = [&](uint32_t a, uint32_t b)
+			{
+				Quadric q = quadrics[a];
+				q.add(quadrics[b]);
+				double toB = q.error(positions[b]);
+				double toA = q.error(positions[a]);
+				if (toB <= toA)
+				{
+					collapses.push({ toB, a, b, versions[a], versions[b] });
+				}
+				else
+				{
+					collapses.push({ toA, b, a, versions[b], versions[a] });
+				}
+			};
+
+		for (const auto& edge : edgeUse)
+		{
+			pushEdge(static_cast<uint32_t>(edge.first >> 32), static_cast<uint32_t>(edge.first & 0xffffffffu));
+		}
+
+		//moving from onto to must not turn any of from's remaining triangles over
+		auto flips = [&](uint32_t from, uint32_t to)
+			{
+				for (uint32_t t : positionTriangles[from])
+				{
+					if (!triangleAlive[t]) continue;
+
+					std::array<uint32_t, 3> corners{};
+					bool hasTo = false;
+					for (int c = 0; c < 3; c++)
+					{
+						corners[c] = vertexPosition[triangles[t][c]];
+						hasTo |= corners[c] == to;
+					}
+					if (hasTo) continue;
+
+					glm::vec3 before = glm::cross(positions[corners[1]] - positions[corners[0]], positions[corners[2]] - positions[corners[0]]);
+					for (auto& corner : corners)
+					{
+						if (corner == from) corner = to;
+					}
+					glm::vec3 after = glm::cross(positions[corners[1]] - positions[corners[0]], positions[corners[2]] - positions[corners[0]]);
+					if (glm::dot(before, after) <= 0.f)
+					{
+						return true;
+					}
+				}
+				return false;
+			};
+
+		//the vertex at position to that best matches the attributes of vertex, so seams stay where they were
+		auto closestVertexAt = [&](uint32_t position, uint32_t vertex)
+			{
+				uint32_t best = sortedVertices[positionVertexOffsets[position]];
+				float bestDistance = attributeDistance(vertices[vertex], vertices[best]);
+				for (uint32_t i = positionVertexOffsets[position] + 1; i < positionVertexOffsets[position + 1]; i++)
+				{
+					float distance = attributeDistance(vertices[vertex], vertices[sortedVertices[i]]);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						best = sortedVertices[i];
+					}
+				}
+				return best;
+			};
+
+		std::vector<float> thresholds = maxErrors;
+		std::sort(thresholds.begin(), thresholds.end());
+		size_t previousTriangles = aliveTriangles;
+		double acceptedCost = 0.0;
+
+		for (float threshold : thresholds)
+		{
+			double maxCost = static_cast<double>(threshold) * threshold;
+
+			while (!collapses.empty() && collapses.top().cost <= maxCost)
+			{
+				Collapse collapse = collapses.top();
+				collapses.pop();
+
+				uint32_t from = collapse.from;
+				uint32_t to = collapse.to;
+				if (!positionAlive[from] || !positionAlive[to] || versions[from] != collapse.fromVersion || versions[to] != collapse.toVersion)
+				{
+					continue;
+				}
+				if (flips(from, to))
+				{
+					continue;
+				}
+
+				for (uint32_t t : positionTriangles[from])
+				{
+					if (!triangleAlive[t]) continue;
+
+					bool hasTo = false;
+					for (uint32_t v : triangles[t]) hasTo |= vertexPosition[v] == to;
+					if (hasTo)
+					{
+						triangleAlive[t] = false;
+						aliveTriangles--;
+						continue;
+					}
+
+					for (uint32_t& v : triangles[t])
+					{
+						if (vertexPosition[v] == from) v = closestVertexAt(to, v);
+					}
+					positionTriangles[to].push_back(t);
+				}
+
+				positionAlive[from] = false;
+				positionTriangles[from].clear();
+				quadrics[to].add(quadrics[from]);
+				versions[to]++;
+				acceptedCost = std::max(acceptedCost, collapse.cost);
+
+				//drop dead triangles from to's list and requeue its edges with the merged quadric
+				auto& around = positionTriangles[to];
+				around.erase(std::remove_if(around.begin(), around.end(), [&](uint32_t t) { return !triangleAlive[t]; }), around.end());
+				std::sort(around.begin(), around.end());
+				around.erase(std::unique(around.begin(), around.end()), around.end());
+
+				for (uint32_t t : around)
+				{
+					for (uint32_t v : triangles[t])
+					{
+						uint32_t neighbour = vertexPosition[v];
+						if (neighbour != to) pushEdge(to, neighbour);
+					}
+				}
+			}
+
+			if (aliveTriangles <= previousTriangles * MIN_LEVEL_REDUCTION && aliveTriangles > 0)
+			{
+				Level level{};
+				level.error = static_cast<float>(std::sqrt(acceptedCost));
+				level.indices.reserve(aliveTriangles * 3);
+				for (size_t t = 0; t < triangles.size(); t++)
+				{
+					if (triangleAlive[t]) level.indices.insert(level.indices.end(), triangles[t].begin(), triangles[t].end());
+				}
+				levels.push_back(std::move(level));
+				previousTriangles = aliveTriangles;
+			}
+		}
+
+		return levels;
+	}
+}
\ No newline at end of file
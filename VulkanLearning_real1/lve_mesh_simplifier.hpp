@@ -0,0 +1,29 @@
+#pragma once
+
+#include "lve_model.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace lve
+{
+	// Quadric error metric edge collapse (Garland and Heckbert) used to build a mesh's LOD chain at import.
+	// Collapses only move a vertex onto one of its neighbours, so every level indexes into the original vertex array.
+	class LveMeshSimplifier
+	{
+	public:
+		struct Level
+		{
+			std::vector<uint32_t> indices;
+			float error;	//largest collapse error accepted for this level, in model units
+		};
+
+		//one progressive simplification, a level is taken each time the next maxErrors value (model units, ascending)
+		//would be exceeded; levels that barely remove triangles are dropped, so fewer levels than thresholds may come back
+		static std::vector<Level> buildLodChain(const std::vector<LveModel::Vertex>& vertices, const std::vector<uint32_t>& indices,
+			const std::vector<float>& maxErrors);
+
+		//a level must keep at most this fraction of the previous level's triangles to be worth storing
+		static constexpr float MIN_LEVEL_REDUCTION = 0.85f;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "lve_meshlet.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace lve
+{
+	static constexpr uint32_t UNUSED = UINT32_MAX;
+
+	static MeshletBounds computeMeshletBounds(const std::vector<glm::vec3>& positions, const uint32_t* meshletVertices,
+		uint32_t vertexCount, const uint8_t* meshletTriangles, uint32_t triangleCount)
+	{
+		MeshletBounds bounds{};
+
+		glm::vec3 minimum = positions[meshletVertices[0]];
+		glm::vec3 maximum = minimum;
+		for (uint32_t i = 1; i < vertexCount; i++)
+		{
+			minimum = glm::min(minimum, positions[meshletVertices[i]]);
+			maximum = glm::max(maximum, positions[meshletVertices[i]]);
+		}
+
+		glm::vec3 center = (minimum + maximum) * .5f;
+		float radius = 0.f;
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			radius = std::max(radius, glm::length(positions[meshletVertices[i]] - center));
+		}
+		bounds.sphere = glm::vec4{ center, radius };
+
+		std::vector<glm::vec3> normals;
+		normals.reserve(triangleCount);
+		glm::vec3 axis{ 0.f };
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const glm::vec3& p0 = positions[meshletVertices[meshletTriangles[t * 3 + 0]]];
+			const glm::vec3& p1 = positions[meshletVertices[meshletTriangles[t * 3 + 1]]];
+			const glm::vec3& p2 = positions[meshletVertices[meshletTriangles[t * 3 + 2]]];
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+			if (area > 0.f)
+			{
+				normals.push_back(normal / area);
+				axis += normal / area;
+			}
+		}
+
+		//cutoff 1 can never pass the backface test, used whenever the normals spread over a half space or more
+		bounds.cone = glm::vec4{ 0.f, 0.f, 0.f, 1.f };
+		float axisLength = glm::length(axis);
+		if (axisLength == 0.f)
+		{
+			return bounds;
+		}
+		axis /= axisLength;
+
+		float minimumDot = 1.f;
+		for (const auto& normal : normals)
+		{
+			minimumDot = std::min(minimumDot, glm::dot(normal, axis));
+		}
+
+		if (minimumDot > 0.f)
+		{
+			bounds.cone = glm::vec4{ axis, std::sqrt(1.f - minimumDot * minimumDot) };
+		}
+		return bounds;
+	}
+
+	MeshletData LveMeshlets::build(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+		uint32_t maxVertices, uint32_t maxTriangles)
+	{
+		assert(indices.size() % 3 == 0 && "Index count must be a multiple of 3");
+		assert(maxVertices >= 3 && maxVertices <= 256 && "Meshlet vertices are addressed with 8 bits");
+		assert(maxTriangles >= 1 && "A meshlet needs room for a triangle");
+
+		MeshletData data{};
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return data;
+		}
+
+		std::vector<uint32_t> adjacencyOffsets(positions.size() + 1, 0);
+		for (uint32_t index : indices)
+		{
+			adjacencyOffsets[index + 1]++;
+		}
+		for (size_t v = 0; v < positions.size(); v++)
+		{
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		}
+
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		std::vector<bool> used(triangleCount, false);
+		std::vector<uint32_t> localIndex(positions.size(), UNUSED);
+		std::vector<uint32_t> meshletVertices;
+		meshletVertices.reserve(maxVertices);
+
+		Meshlet meshlet{};
+		glm::vec3 centroidSum{ 0.f };
+
+		auto triangleCenter = [&](uint32_t t)
+			{
+				return (positions[indices[t * 3 + 0]] + positions[indices[t * 3 + 1]] + positions[indices[t * 3 + 2]]) / 3.f;
+			};
+
+		auto newVertices = [&](uint32_t t)
+			{
+				uint32_t count = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					count += localIndex[indices[t * 3 + c]] == UNUSED;
+				}
+				return count;
+			};
+
+		auto addTriangle = [&](uint32_t t)
+			{
+				for (int c = 0; c < 3; c++)
+				{
+					uint32_t v = indices[t * 3 + c];
+					if (localIndex[v] == UNUSED)
+					{
+						localIndex[v] = static_cast<uint32_t>(meshletVertices.size());
+						meshletVertices.push_back(v);
+					}
+					data.triangles.push_back(static_cast<uint8_t>(localIndex[v]));
+				}
+				used[t] = true;
+				meshlet.triangleCount++;
+				centroidSum += triangleCenter(t);
+			};
+
+		size_t seed = 0;
+		size_t remaining = triangleCount;
+		while (remaining > 0)
+		{
+			while (used[seed]) seed++;
+
+			meshlet = {};
+			meshlet.vertexOffset = static_cast<uint32_t>(data.vertices.size());
+			meshlet.triangleOffset = static_cast<uint32_t>(data.triangles.size() / 3);
+			centroidSum = glm::vec3{ 0.f };
+			addTriangle(static_cast<uint32_t>(seed));
+
+			while (meshlet.triangleCount < maxTriangles)
+			{
+				glm::vec3 centroid = centroidSum / static_cast<float>(meshlet.triangleCount);
+				uint32_t best = UNUSED;
+				uint32_t bestNewVertices = 4;
+				float bestDistance = 0.f;
+
+				for (uint32_t v : meshletVertices)
+				{
+					for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++)
+					{
+						uint32_t t = adjacency[a];
+						if (used[t]) continue;
+
+						uint32_t added = newVertices(t);
+						if (meshletVertices.size() + added > maxVertices) continue;
+
+						float distance = glm::length(triangleCenter(t) - centroid);
+						if (added < bestNewVertices || (added == bestNewVertices && distance < bestDistance))
+						{
+							best = t;
+							bestNewVertices = added;
+							bestDistance = distance;
+						}
+					}
+				}
+
+				if (best == UNUSED) break;
+				addTriangle(best);
+			}
+
+			meshlet.vertexCount = static_cast<uint32_t>(meshletVertices.size());
+			remaining -= meshlet.triangleCount;
+
+			data.bounds.push_back(computeMeshletBounds(positions, meshletVertices.data(), meshlet.vertexCount,
+				data.triangles.data() + meshlet.triangleOffset * 3, meshlet.triangleCount));
+			data.meshlets.push_back(meshlet);
+			data.vertices.insert(data.vertices.end(), meshletVertices.begin(), meshletVertices.end());
+
+			for (uint32_t v : meshletVertices)
+			{
+				localIndex[v] = UNUSED;
+			}
+			meshletVertices.clear();
+		}
+
+		return data;
+	}
+
+	std::array<glm::vec4, 6> LveMeshlets::extractFrustumPlanes(const glm::mat4& viewProjection)
+	{
+		//Gribb and Hartmann, with a 0..1 depth range for the near plane
+		auto row = [&](int i) { return glm::vec4{ viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i] }; };
+
+		std::array<glm::vec4, 6> planes{
+			row(3) + row(0),
+			row(3) - row(0),
+			row(3) + row(1),
+			row(3) - row(1),
+			row(2),
+			row(3) - row(2) };
+
+		for (auto& plane : planes)
+		{
+			float length = glm::length(glm::vec3{ plane });
+			if (length > 0.f)
+			{
+				plane /= length;
+			}
+		}
+		return planes;
+	}
+
+	bool LveMeshlets::isOutsideFrustum(const MeshletBounds& bounds, const std::array<glm::vec4, 6>& planes)
+	{
+		glm::vec3 center{ bounds.sphere };
+		for (const auto& plane : planes)
+		{
+			if (glm::dot(glm::vec3{ plane }, center) + plane.w < -bounds.sphere.w)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool LveMeshlets::isBackfacing(const MeshletBounds& bounds, const glm::vec3& cameraPosition)
+	{
+		//every view ray into the sphere must lie inside the cone's complement, the radius keeps the test conservative
+		glm::vec3 toCenter = glm::vec3{ bounds.sphere } - cameraPosition;
+		return glm::dot(toCenter, glm::vec3{ bounds.cone }) >= bounds.cone.w * glm::length(toCenter) + bounds.sphere.w;
+	}
+
+	MeshletBounds LveMeshlets::transformBounds(const MeshletBounds& bounds, const glm::mat4& modelMatrix)
+	{
+		MeshletBounds transformed{};
+
+		glm::vec3 column0{ modelMatrix[0] };
+		glm::vec3 column1{ modelMatrix[1] };
+		glm::vec3 column2{ modelMatrix[2] };
+		float scale0 = glm::length(column0);
+		float scale1 = glm::length(column1);
+		float scale2 = glm::length(column2);
+		float maxScale = std::max({ scale0, scale1, scale2 });
+
+		glm::vec3 center{ modelMatrix * glm::vec4{ glm::vec3{ bounds.sphere }, 1.f } };
+		transformed.sphere = glm::vec4{ center, bounds.sphere.w * maxScale };
+
+		//the cone only survives uniform scale, mirroring flips the winding and with it the normals
+		bool uniform = std::abs(scale0 - scale1) <= 1e-4f * maxScale && std::abs(scale0 - scale2) <= 1e-4f * maxScale;
+		if (!uniform || bounds.cone.w >= 1.f || maxScale == 0.f)
+		{
+			transformed.cone = glm::vec4{ 0.f, 0.f, 0.f, 1.f };
+			return transformed;
+		}
+
+		float mirror = glm::dot(glm::cross(column0, column1), column2) < 0.f ? -1.f : 1.f;
+		glm::vec3 axis = glm::mat3{ modelMatrix } * glm::vec3{ bounds.cone } * (mirror / maxScale);
+		transformed.cone = glm::vec4{ axis, bounds.cone.w };
+		return transformed;
+	}
+}
\ No newline at end of file
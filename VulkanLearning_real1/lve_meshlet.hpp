@@ -0,0 +1,57 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace lve
+{
+	// A small cluster of a mesh, its vertices and triangles are ranges of MeshletData::vertices and ::triangles
+	struct Meshlet
+	{
+		uint32_t vertexOffset;
+		uint32_t triangleOffset;	//in triangles, each one is three bytes of MeshletData::triangles
+		uint32_t vertexCount;
+		uint32_t triangleCount;
+	};
+
+	// vec4 aligned so the array can be uploaded as is for GPU culling later
+	struct MeshletBounds
+	{
+		glm::vec4 sphere;	//xyz center, w radius, model space
+		glm::vec4 cone;		//xyz normal cone axis, w sine of the cone's half angle, 1 never culls
+	};
+
+	struct MeshletData
+	{
+		std::vector<Meshlet> meshlets;
+		std::vector<MeshletBounds> bounds;
+		std::vector<uint32_t> vertices;		//meshlet local vertex -> index into the model's vertex buffer
+		std::vector<uint8_t> triangles;		//three meshlet local vertex indices per triangle
+	};
+
+	class LveMeshlets
+	{
+	public:
+		static constexpr uint32_t MAX_VERTICES = 64;
+		static constexpr uint32_t MAX_TRIANGLES = 124;
+
+		//grows each cluster over shared vertices from a seed triangle, preferring triangles that add the fewest new vertices
+		static MeshletData build(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices,
+			uint32_t maxVertices = MAX_VERTICES, uint32_t maxTriangles = MAX_TRIANGLES);
+
+		//planes point inwards (dot(plane.xyz, p) + plane.w >= 0 inside), in the space of the matrix's input
+		static std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4& viewProjection);
+
+		//bounds must be in the same space as the planes / camera position, use transformBounds for world space
+		static bool isOutsideFrustum(const MeshletBounds& bounds, const std::array<glm::vec4, 6>& planes);
+		//true when every triangle's cross(p1 - p0, p2 - p0) normal faces away from the camera
+		static bool isBackfacing(const MeshletBounds& bounds, const glm::vec3& cameraPosition);
+
+		static MeshletBounds transformBounds(const MeshletBounds& bounds, const glm::mat4& modelMatrix);
+	};
+}
\ No newline at end of file
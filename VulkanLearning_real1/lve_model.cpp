@@ -1,68 +1,104 @@
 #include "lve_model.hpp"
+#include "lve_mesh_cache.hpp"
+#include "lve_mesh_optimizer.hpp"
+#include "lve_mesh_simplifier.hpp"
+#include "lve_obj_stream_reader.hpp"
+#include "lve_staging_ring.hpp"
+#include "lve_thread_pool.hpp"
 #include "lve_utils.hpp"
+#include "lve_vertex_welder.hpp"
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
-#include <unordered_map>
+#include <filesystem>
+#include <iostream>
 
-namespace std
+namespace lve
 {
-	template <>
-	struct hash<lve::LveModel::Vertex> 
+	LveModel::LveModel(LveDevice& device, const const LveModel::Builder &builder, LveGeometryPool* geometryPool) 
+		: lveDevice{device}, geometryPool{geometryPool}, vertexFormat{builder.vertexFormat}
 	{
-		size_t operator()(lve::LveModel::Vertex const &vertex) const 
+		if (vertexFormat == VertexFormat::Packed)
 		{
-			size_t seed = 0;
-			lve::hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
-			return seed;
+			createVertexBuffers(builder.packedVertices.data(), sizeof(PackedVertex), static_cast<uint32_t>(builder.packedVertices.size()));
+			dequantizeMatrix = glm::translate(glm::mat4{ 1.f }, builder.boundsMin) * glm::scale(glm::mat4{ 1.f }, builder.boundsMax - builder.boundsMin);
+		}
+		else
+		{
+			createVertexBuffers(builder.vertices.data(), sizeof(Vertex), static_cast<uint32_t>(builder.vertices.size()));
 		}
-	};
-}
-
-namespace lve
-{
-	LveModel::LveModel(LveDevice& device, const const LveModel::Builder &builder) : lveDevice{device}
-	{
-		createVertexBuffers(builder.vertices);
 		createIndexBuffers(builder.indices);
+
+		lods = builder.lods;
+		if (lods.empty() && hasIndexBuffer)
+		{
+			lods.push_back({ 0, indexCount, 0.f });
+		}
+
+		boundsCenter = (builder.boundsMin + builder.boundsMax) * .5f;
+		boundsRadius = glm::length(builder.boundsMax - builder.boundsMin) * .5f;
+
+		meshlets = builder.meshlets;
 	}
 	
-	LveModel::~LveModel() {}
+	LveModel::~LveModel() 
+	{
+		if (vertexRange.isValid())
+		{
+			geometryPool->freeVertices(vertexRange);
+		}
+		if (indexRange.isValid())
+		{
+			geometryPool->freeIndices(indexRange);
+		}
+	}
 
-	std::unique_ptr<LveModel> LveModel::createModelFromFile(LveDevice& device, const std::string& filepath)
+	size_t ModelImportOptions::hash() const
+	{
+		size_t seed = 0;
+		hashCombine(seed, useMeshCache, static_cast<int>(vertexFormat), optimizeMesh, buildMeshlets, processStreamedImports);
+		for (float error : lodErrors)
+		{
+			hashCombine(seed, error);
+		}
+		return seed;
+	}
+
+	std::unique_ptr<LveModel> LveModel::createModelFromFile(LveDevice& device, const std::string& filepath,
+		const ModelImportOptions& options, LveGeometryPool* geometryPool)
 	{
 		Builder builder{};
-		builder.loadModel(filepath);
-		return std::make_unique<LveModel>(device, builder);
+		builder.loadModel(filepath, options);
+		return std::make_unique<LveModel>(device, builder, geometryPool);
 	}
 
-	void LveModel::createVertexBuffers(const std::vector<Vertex>& vertices)
+	void LveModel::createVertexBuffers(const void* vertices, uint32_t vertexSize, uint32_t count)
 	{
-		vertexCount = static_cast<uint32_t>(vertices.size());
+		vertexCount = count;
 		assert(vertexCount >= 3 && "Vertex count must be at least 3");
-		VkDeviceSize bufferSize = sizeof(vertices[0]) * vertexCount;
-		uint32_t vertexSize = sizeof(vertices[0]);
+		VkDeviceSize bufferSize = static_cast<VkDeviceSize>(vertexSize) * vertexCount;
 
-		LveBuffer stagingBuffer
+		if (geometryPool != nullptr)
 		{
-			lveDevice, vertexSize, vertexCount,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		};
-
-		stagingBuffer.map();
-		stagingBuffer.writeToBuffer((void*)vertices.data());
+			vertexRange = geometryPool->uploadVertices(vertices, vertexSize, vertexCount);
+			if (vertexRange.isValid())
+			{
+				baseVertex = static_cast<int32_t>(vertexRange.offset / vertexSize);
+				return;
+			}
+			std::cout << "Geometry pool is out of vertex space, model gets its own vertex buffer\n";
+		}
 
 		vertexBuffer = std::make_unique<LveBuffer>(lveDevice, vertexSize, vertexCount,
 			VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-		lveDevice.copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+		lveDevice.stagingRing().uploadToBuffer(vertices, bufferSize, vertexBuffer->getBuffer());
 	}
 
 	void LveModel::createIndexBuffers(const std::vector<uint32_t>& indices)
@@ -75,47 +111,81 @@ namespace lve
 			return;
 		}
 
-		VkDeviceSize bufferSize = sizeof(indices[0]) * indexCount;
-		uint32_t indexSize = sizeof(indices[0]);
+		//0xFFFF is left out so the mesh stays valid with primitive restart enabled
+		std::vector<uint16_t> shortIndices;
+		const void* indexData = indices.data();
+		uint32_t indexSize = sizeof(uint32_t);
+		indexType = VK_INDEX_TYPE_UINT32;
 
-		LveBuffer stagingBuffer
+		if (vertexCount < UINT16_MAX)
 		{
-			lveDevice, indexSize, indexCount,
-			 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-		};
+			shortIndices.resize(indices.size());
+			std::transform(indices.begin(), indices.end(), shortIndices.begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
+			indexData = shortIndices.data();
+			indexSize = sizeof(uint16_t);
+			indexType = VK_INDEX_TYPE_UINT16;
+		}
+
+		VkDeviceSize bufferSize = static_cast<VkDeviceSize>(indexSize) * indexCount;
 
-		stagingBuffer.map();
-		stagingBuffer.writeToBuffer((void*)indices.data());
+		if (geometryPool != nullptr)
+		{
+			indexRange = geometryPool->uploadIndices(indexData, indexSize, indexCount);
+			if (indexRange.isValid())
+			{
+				baseIndex = static_cast<uint32_t>(indexRange.offset / indexSize);
+				return;
+			}
+			std::cout << "Geometry pool is out of index space, model gets its own index buffer\n";
+		}
 
 		indexBuffer = std::make_unique<LveBuffer>(lveDevice, indexSize, indexCount,
 				VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
 				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-		lveDevice.copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), bufferSize);
+		lveDevice.stagingRing().uploadToBuffer(indexData, bufferSize, indexBuffer->getBuffer());
 	}
 
-	void LveModel::draw(VkCommandBuffer commandBuffer)
+	void LveModel::draw(VkCommandBuffer commandBuffer, uint32_t lod)
 	{
 		if (hasIndexBuffer)
 		{
-			vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+			const Lod& range = lods[std::min<size_t>(lod, lods.size() - 1)];
+			vkCmdDrawIndexed(commandBuffer, range.indexCount, 1, baseIndex + range.firstIndex, baseVertex, 0);
 		}
 		else
 		{
-			vkCmdDraw(commandBuffer, vertexCount, 1, 0, 0);
+			vkCmdDraw(commandBuffer, vertexCount, 1, static_cast<uint32_t>(baseVertex), 0);
 		}		
 	}
 
 	void LveModel::bind(VkCommandBuffer commandBuffer)
 	{
-		VkBuffer buffers[] = { vertexBuffer->getBuffer() };
-		VkDeviceSize offsets[] = { 0 };
-		vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+		BindState state{};
+		bind(commandBuffer, state);
+	}
+
+	void LveModel::bind(VkCommandBuffer commandBuffer, BindState& state)
+	{
+		//pool ranges are addressed through the draw offsets, so the pool buffers are always bound at offset 0
+		VkBuffer vertex = vertexRange.isValid() ? geometryPool->getVertexBuffer() : vertexBuffer->getBuffer();
+		if (vertex != state.vertexBuffer)
+		{
+			VkBuffer buffers[] = { vertex };
+			VkDeviceSize offsets[] = { 0 };
+			vkCmdBindVertexBuffers(commandBuffer, 0, 1, buffers, offsets);
+			state.vertexBuffer = vertex;
+		}
 
 		if (hasIndexBuffer) 
 		{
-			vkCmdBindIndexBuffer(commandBuffer, indexBuffer->getBuffer(), 0, VK_INDEX_TYPE_UINT32);
+			VkBuffer index = indexRange.isValid() ? geometryPool->getIndexBuffer() : indexBuffer->getBuffer();
+			if (index != state.indexBuffer || indexType != state.indexType)
+			{
+				vkCmdBindIndexBuffer(commandBuffer, index, 0, indexType);
+				state.indexBuffer = index;
+				state.indexType = indexType;
+			}
 		}
 	}
 
@@ -140,65 +210,342 @@ namespace lve
 		return attributeDescriptions;
 	}
 
-	void LveModel::Builder::loadModel(const std::string& filepath)
+	std::vector<VkVertexInputBindingDescription> LveModel::PackedVertex::getBindingDescriptions()
 	{
-		tinyobj::attrib_t attrib;
-		std::vector<tinyobj::shape_t> shapes;
-		std::vector<tinyobj::material_t> materials;
-		std::string warn, err;
+		std::vector<VkVertexInputBindingDescription> bindingDescriptions(1);
+		bindingDescriptions[0].binding = 0;
+		bindingDescriptions[0].stride = sizeof(PackedVertex);
+		bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+		return bindingDescriptions;
+	}
+
+	std::vector<VkVertexInputAttributeDescription> LveModel::PackedVertex::getAttributeDescriptions()
+	{
+		std::vector<VkVertexInputAttributeDescription> attributeDescriptions{};
+
+		//same locations as Vertex, see simple_shader_packed.vert
+		attributeDescriptions.push_back({ 0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(PackedVertex, position) });
+		attributeDescriptions.push_back({ 1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(PackedVertex, color) });
+		attributeDescriptions.push_back({ 2, 0, VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal) });
+		attributeDescriptions.push_back({ 3, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(PackedVertex, uv) });
+
+		return attributeDescriptions;
+	}
+
+	void LveModel::Builder::loadModel(const std::string& filepath, const ModelImportOptions& options)
+	{
+		//the cache holds the finished builder for these options, a hit skips the import and every step below
+		if (options.useMeshCache && LveMeshCache::read(filepath, options, *this))
+		{
+			return;
+		}
+
+		bool streamed = importObj(filepath);
+		computeBounds();
+
+		bool process = !streamed || options.processStreamedImports;
+		if (process && !options.lodErrors.empty())
+		{
+			generateLods(options.lodErrors);
+		}
+
+		if (process && options.optimizeMesh)
+		{
+			optimizeMesh();
+		}
 
-		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str()))
+		if (process && options.buildMeshlets)
 		{
-			throw std::runtime_error(warn + err);
+			buildMeshlets();
 		}
 
+		vertexFormat = options.vertexFormat;
+		if (vertexFormat == VertexFormat::Packed)
+		{
+			packVertices();
+		}
+
+		if (options.useMeshCache)
+		{
+			LveMeshCache::write(filepath, options, *this);
+		}
+	}
+
+	void LveModel::Builder::computeBounds()
+	{
+		if (vertices.empty())
+		{
+			boundsMin = boundsMax = glm::vec3{ 0.f };
+			return;
+		}
+
+		boundsMin = boundsMax = vertices[0].position;
+		for (const auto& vertex : vertices)
+		{
+			boundsMin = glm::min(boundsMin, vertex.position);
+			boundsMax = glm::max(boundsMax, vertex.position);
+		}
+	}
+
+	void LveModel::Builder::generateLods(const std::vector<float>& relativeErrors)
+	{
+		lods.clear();
+		if (indices.empty())
+		{
+			return;
+		}
+
+		float radius = glm::length(boundsMax - boundsMin) * .5f;
+		std::vector<float> maxErrors;
+		for (float error : relativeErrors)
+		{
+			maxErrors.push_back(error * radius);
+		}
+
+		auto levels = LveMeshSimplifier::buildLodChain(vertices, indices, maxErrors);
+
+		lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.f });
+		for (auto& level : levels)
+		{
+			lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(level.indices.size()), level.error });
+			indices.insert(indices.end(), level.indices.begin(), level.indices.end());
+		}
+	}
+
+	void LveModel::Builder::optimizeMesh()
+	{
+		if (indices.empty())
+		{
+			return;
+		}
+
+		//stats are taken on level 0, the mesh that is drawn up close
+		auto levelZero = [this] { return std::vector<uint32_t>(indices.begin(), indices.begin() + (lods.empty() ? indices.size() : lods[0].indexCount)); };
+		cacheStatsBefore = LveMeshOptimizer::analyzeVertexCache(levelZero(), vertices.size());
+
+		//each level is reordered on its own, the vertex order then follows first use across all of them
+		if (lods.empty())
+		{
+			LveMeshOptimizer::optimizeVertexCache(indices, vertices.size());
+			LveMeshOptimizer::optimizeOverdraw(indices, vertices);
+		}
+		else
+		{
+			for (const auto& lod : lods)
+			{
+				std::vector<uint32_t> levelIndices(indices.begin() + lod.firstIndex, indices.begin() + lod.firstIndex + lod.indexCount);
+				LveMeshOptimizer::optimizeVertexCache(levelIndices, vertices.size());
+				LveMeshOptimizer::optimizeOverdraw(levelIndices, vertices);
+				std::copy(levelIndices.begin(), levelIndices.end(), indices.begin() + lod.firstIndex);
+			}
+		}
+		LveMeshOptimizer::optimizeVertexFetch(vertices, indices);
+
+		cacheStatsAfter = LveMeshOptimizer::analyzeVertexCache(levelZero(), vertices.size());
+	}
+
+	void LveModel::Builder::buildMeshlets()
+	{
+		std::vector<glm::vec3> positions(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			positions[i] = vertices[i].position;
+		}
+
+		uint32_t levelZeroCount = lods.empty() ? static_cast<uint32_t>(indices.size()) : lods[0].indexCount;
+		meshlets = LveMeshlets::build(positions, std::vector<uint32_t>(indices.begin(), indices.begin() + levelZeroCount));
+	}
+
+	static uint16_t quantizeUnorm16(float value)
+	{
+		return static_cast<uint16_t>(std::lround(std::clamp(value, 0.f, 1.f) * 65535.f));
+	}
+
+	static int16_t quantizeSnorm16(float value)
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.f, 1.f) * 32767.f));
+	}
+
+	//octahedral mapping, the shader undoes it in decodeOctahedral()
+	static glm::vec2 encodeOctahedral(const glm::vec3& normal)
+	{
+		float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (length == 0.f)
+		{
+			return glm::vec2{ 0.f };
+		}
+
+		glm::vec2 octahedral{ normal.x / length, normal.y / length };
+		if (normal.z < 0.f)
+		{
+			octahedral = glm::vec2{
+				(1.f - std::abs(octahedral.y)) * (octahedral.x >= 0.f ? 1.f : -1.f),
+				(1.f - std::abs(octahedral.x)) * (octahedral.y >= 0.f ? 1.f : -1.f) };
+		}
+		return octahedral;
+	}
+
+	void LveModel::Builder::packVertices()
+	{
+		glm::vec3 extent = boundsMax - boundsMin;
+		glm::vec3 inverseExtent{
+			extent.x > 0.f ? 1.f / extent.x : 0.f,
+			extent.y > 0.f ? 1.f / extent.y : 0.f,
+			extent.z > 0.f ? 1.f / extent.z : 0.f };
+
+		packedVertices.resize(vertices.size());
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			const Vertex& vertex = vertices[i];
+			PackedVertex& packed = packedVertices[i];
+
+			glm::vec3 position = (vertex.position - boundsMin) * inverseExtent;
+			packed.position[0] = quantizeUnorm16(position.x);
+			packed.position[1] = quantizeUnorm16(position.y);
+			packed.position[2] = quantizeUnorm16(position.z);
+			packed.position[3] = 0;
+
+			glm::vec2 normal = encodeOctahedral(vertex.normal);
+			packed.normal[0] = quantizeSnorm16(normal.x);
+			packed.normal[1] = quantizeSnorm16(normal.y);
+
+			packed.uv[0] = glm::packHalf1x16(vertex.uv.x);
+			packed.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+			packed.color[0] = static_cast<uint8_t>(std::lround(std::clamp(vertex.color.x, 0.f, 1.f) * 255.f));
+			packed.color[1] = static_cast<uint8_t>(std::lround(std::clamp(vertex.color.y, 0.f, 1.f) * 255.f));
+			packed.color[2] = static_cast<uint8_t>(std::lround(std::clamp(vertex.color.z, 0.f, 1.f) * 255.f));
+			packed.color[3] = 255;
+		}
+	}
+
+	static LveModel::Vertex makeObjVertex(const tinyobj::attrib_t& attrib, const tinyobj::index_t& index)
+	{
+		LveModel::Vertex vertex{};
+
+		if (index.vertex_index >= 0)
+		{
+			vertex.position = { 
+			attrib.vertices[3 * index.vertex_index + 0],
+			attrib.vertices[3 * index.vertex_index + 1],
+			attrib.vertices[3 * index.vertex_index + 2], };
+
+			vertex.color = {
+			attrib.colors[3 * index.vertex_index + 0],
+			attrib.colors[3 * index.vertex_index + 1],
+			attrib.colors[3 * index.vertex_index + 2], };
+		}
+
+		if (index.normal_index >= 0)
+		{
+			vertex.normal = { 
+			attrib.normals[3 * index.normal_index + 0],
+			attrib.normals[3 * index.normal_index + 1],
+			attrib.normals[3 * index.normal_index + 2], };
+		}
+
+		if (index.texcoord_index >= 0)
+		{
+			vertex.uv = {
+			attrib.texcoords[2 * index.texcoord_index + 0],
+			1.f - attrib.texcoords[2 * index.texcoord_index + 1], };
+		}
+
+		return vertex;
+	}
+
+	bool LveModel::Builder::importObj(const std::string& filepath)
+	{
+		std::error_code sizeError;
+		uint64_t fileSize = std::filesystem::file_size(filepath, sizeError);
+		if (!sizeError && fileSize >= STREAMING_IMPORT_BYTES)
+		{
+			LveObjStreamReader::read(filepath, vertices, indices);
+			return true;
+		}
+
+		tinyobj::attrib_t attrib;
+		std::vector<tinyobj::index_t> corners;
+		LveObjStreamReader::readCorners(filepath, attrib, corners);
+
 		vertices.clear();
 		indices.clear();
 
-		std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+		//the corners are cut into fixed size index ranges so a single huge mesh still spreads over the workers
+		struct ImportChunk
+		{
+			size_t begin;
+			size_t end;
+			std::vector<Vertex> vertices;
+			std::vector<uint32_t> indices;
+		};
 
-		for (const auto& shape : shapes)
+		size_t indexCount = corners.size();
+		std::vector<ImportChunk> chunks;
+		for (size_t begin = 0; begin < indexCount; begin += IMPORT_CHUNK_INDICES)
 		{
-			for (const auto& index : shape.mesh.indices)
-			{
-				Vertex vertex{};
+			chunks.push_back({ begin, std::min(begin + IMPORT_CHUNK_INDICES, indexCount) });
+		}
 
-				if (index.vertex_index >= 0)
-				{
-					vertex.position = { 
-					attrib.vertices[3 * index.vertex_index + 0],
-					attrib.vertices[3 * index.vertex_index + 1],
-					attrib.vertices[3 * index.vertex_index + 2], };
-
-					vertex.color = {
-					attrib.colors[3 * index.vertex_index + 0],
-					attrib.colors[3 * index.vertex_index + 1],
-					attrib.colors[3 * index.vertex_index + 2], };
-				}
+		LveThreadPool& pool = LveThreadPool::shared();
 
-				if (index.normal_index >= 0)
+		if (chunks.size() <= 1 || pool.getThreadCount() <= 1)
+		{
+			indices.reserve(indexCount);
+			LveVertexWelder welder{ indexCount };
+			for (const auto& chunk : chunks)
+			{
+				for (size_t i = chunk.begin; i < chunk.end; i++)
 				{
-					vertex.normal = { 
-					attrib.normals[3 * index.normal_index + 0],
-					attrib.normals[3 * index.normal_index + 1],
-					attrib.normals[3 * index.normal_index + 2], };
+					indices.push_back(welder.weld(makeObjVertex(attrib, corners[i]), vertices));
 				}
+			}
+			return false;
+		}
 
-				if (index.texcoord_index >= 0)
+		pool.parallelFor(static_cast<uint32_t>(chunks.size()), [&](uint32_t chunkIndex)
+			{
+				ImportChunk& chunk = chunks[chunkIndex];
+				chunk.indices.reserve(chunk.end - chunk.begin);
+				LveVertexWelder welder{ chunk.end - chunk.begin };
+				for (size_t i = chunk.begin; i < chunk.end; i++)
 				{
-					vertex.uv = {
-					attrib.texcoords[2 * index.texcoord_index + 0],
-					1.f - attrib.texcoords[2 * index.texcoord_index + 1], };
+					chunk.indices.push_back(welder.weld(makeObjVertex(attrib, corners[i]), chunk.vertices));
 				}
+			});
 
-				if (uniqueVertices.count(vertex) == 0)
-				{
-					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-					vertices.push_back(vertex);
-				}
-				indices.push_back(uniqueVertices[vertex]);
+		//welding the chunk-local vertices in chunk order keeps every vertex at its first appearance in the whole
+		//index stream, so the result is identical to the serial path
+		size_t localVertexCount = 0;
+		for (const auto& chunk : chunks)
+		{
+			localVertexCount += chunk.vertices.size();
+		}
+
+		std::vector<std::vector<uint32_t>> remaps(chunks.size());
+		LveVertexWelder welder{ localVertexCount };
+		for (size_t c = 0; c < chunks.size(); c++)
+		{
+			remaps[c].reserve(chunks[c].vertices.size());
+			for (const auto& vertex : chunks[c].vertices)
+			{
+				remaps[c].push_back(welder.weld(vertex, vertices));
 			}
+			std::vector<Vertex>().swap(chunks[c].vertices);
 		}
+
+		indices.resize(indexCount);
+		pool.parallelFor(static_cast<uint32_t>(chunks.size()), [&](uint32_t chunkIndex)
+			{
+				const ImportChunk& chunk = chunks[chunkIndex];
+				const std::vector<uint32_t>& remap = remaps[chunkIndex];
+				uint32_t* out = indices.data() + chunk.begin;
+				for (size_t i = 0; i < chunk.indices.size(); i++)
+				{
+					out[i] = remap[chunk.indices[i]];
+				}
+			});
+		return false;
 	}
 
 }
\ No newline at end of file
@@ -2,16 +2,54 @@
 
 #include "lve_device.hpp"
 #include "lve_buffer.hpp"
+#include "lve_geometry_pool.hpp"
+#include "lve_meshlet.hpp"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace lve
 {
+	enum class VertexFormat
+	{
+		Full,	//LveModel::Vertex, 44 bytes of floats
+		Packed	//LveModel::PackedVertex, 20 bytes, drawn with the packed shader variant
+	};
+
+	// Settings applied while importing a model file, two loads of the same path only share data if these are equal
+	struct ModelImportOptions
+	{
+		bool useMeshCache = true;	//read and refresh the binary .lvemesh cache next to the source file
+		VertexFormat vertexFormat = VertexFormat::Full;
+		bool optimizeMesh = false;	//vertex cache, overdraw and vertex fetch reordering, see LveMeshOptimizer
+		//max simplification error of each generated LOD, as a fraction of the bounding sphere radius, empty for no LODs
+		std::vector<float> lodErrors{ .005f, .02f, .05f };
+		bool buildMeshlets = false;	//clusters of LOD 0 with culling bounds, see LveMeshlets
+		//files of at least Builder::STREAMING_IMPORT_BYTES skip LODs, optimizeMesh and meshlets unless this is set,
+		//they need several times the welded mesh in memory while streaming keeps the import close to its final size
+		bool processStreamedImports = false;
+
+		bool operator ==(const ModelImportOptions& other) const 
+		{ 
+			return useMeshCache == other.useMeshCache && vertexFormat == other.vertexFormat && optimizeMesh == other.optimizeMesh
+				&& lodErrors == other.lodErrors && buildMeshlets == other.buildMeshlets
+				&& processStreamedImports == other.processStreamedImports; 
+		}
+		size_t hash() const;
+	};
+
+	// Post-transform vertex cache figures of an index buffer, see LveMeshOptimizer::analyzeVertexCache
+	struct VertexCacheStats
+	{
+		float acmr = 0.f;	//average cache miss ratio, transformed vertices per triangle (0.5 is ideal, 3 is worst)
+		float atvr = 0.f;	//average transform to vertex ratio, transformed vertices per referenced vertex (1 is ideal)
+	};
+
 	class LveModel
 	{
 
@@ -31,6 +69,27 @@ namespace lve
 				&& normal == other.normal && uv == other.uv; }
 		};
 
+		// position is unorm16 relative to the mesh bounds (undone by getDequantizeMatrix()), normal is octahedral snorm16,
+		// uv is half float and color is rgba8
+		struct PackedVertex
+		{
+			uint16_t position[4];	//w is padding, three component 16 bit formats are not guaranteed for vertex input
+			int16_t normal[2];
+			uint16_t uv[2];
+			uint8_t color[4];
+
+			static std::vector<VkVertexInputBindingDescription> getBindingDescriptions();
+			static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+		};
+
+		//range of the shared index buffer drawn for one level of detail, level 0 is the full mesh
+		struct Lod
+		{
+			uint32_t firstIndex;
+			uint32_t indexCount;
+			float error;	//simplification error in model units
+		};
+
 		struct UniformBufferObject {
 			alignas(16) glm::mat4 model;
 			alignas(16) glm::mat4 view;
@@ -39,13 +98,52 @@ namespace lve
 
 		struct Builder
 		{
+			//index range welded per worker task by the parallel OBJ import
+			static constexpr size_t IMPORT_CHUNK_INDICES = 1 << 18;
+			//files at least this big are welded while they are parsed to bound peak memory, smaller ones are parsed whole
+			//and welded in parallel
+			static constexpr uint64_t STREAMING_IMPORT_BYTES = 256ull << 20;
+
 			std::vector<Vertex> vertices{};
 			std::vector<uint32_t> indices{};
+			glm::vec3 boundsMin{};
+			glm::vec3 boundsMax{};
+
+			//filled from vertices by packVertices() when the model is imported with VertexFormat::Packed
+			VertexFormat vertexFormat = VertexFormat::Full;
+			std::vector<PackedVertex> packedVertices{};
+
+			//filled by generateLods(), the coarser levels are appended to indices after level 0
+			std::vector<Lod> lods{};
+
+			MeshletData meshlets{};
+
+			//level 0 before and after optimizeMesh(), both stay zero when the mesh wasn't optimized
+			VertexCacheStats cacheStatsBefore{};
+			VertexCacheStats cacheStatsAfter{};
+
+			//reads the binary mesh cache when it is up to date, otherwise imports the OBJ and refreshes the cache
+			void loadModel(const std::string& filepath, const ModelImportOptions& options = ModelImportOptions{});
+			//true when the file was big enough to be streamed
+			bool importObj(const std::string& filepath);
+			void computeBounds();
+			void generateLods(const std::vector<float>& relativeErrors);
+			void optimizeMesh();
+			void buildMeshlets();
+			void packVertices();
+		};
 
-			void loadModel(const std::string& filepath);
+		//last bound buffers of a command buffer, lets consecutive pooled models skip the rebind
+		struct BindState
+		{
+			VkBuffer vertexBuffer = VK_NULL_HANDLE;
+			VkBuffer indexBuffer = VK_NULL_HANDLE;
+			VkIndexType indexType = VK_INDEX_TYPE_MAX_ENUM;
 		};
 
-		LveModel(LveDevice & device, const LveModel::Builder &builder);
+		//with a geometry pool the model lives in ranges of the pool's buffers, it falls back to buffers of its own
+		//when the pool is full
+		LveModel(LveDevice & device, const LveModel::Builder &builder, LveGeometryPool* geometryPool = nullptr);
 		~LveModel();
 
 		LveModel(const LveModel&) = delete;
@@ -57,22 +155,54 @@ namespace lve
 
 		std::vector<VkDescriptorSet> descriptorSets;
 
-		static std::unique_ptr<LveModel> createModelFromFile(LveDevice& device, const std::string &filepath);
+		static std::unique_ptr<LveModel> createModelFromFile(LveDevice& device, const std::string &filepath,
+			const ModelImportOptions& options = ModelImportOptions{}, LveGeometryPool* geometryPool = nullptr);
 
 		void bind(VkCommandBuffer);
-		void draw(VkCommandBuffer);
+		//only records the binds that differ from state, then updates it
+		void bind(VkCommandBuffer commandBuffer, BindState& state);
+		//lod is clamped to the coarsest level the model has
+		void draw(VkCommandBuffer commandBuffer, uint32_t lod = 0);
+
+		const std::vector<Lod>& getLods() const { return lods; }
+		//bounding sphere of the model in model space
+		const glm::vec3& getBoundsCenter() const { return boundsCenter; }
+		float getBoundsRadius() const { return boundsRadius; }
+		//cpu side only for now, empty unless imported with buildMeshlets
+		const MeshletData& getMeshlets() const { return meshlets; }
+
+		bool isPooled() const { return vertexRange.isValid(); }
+		VertexFormat getVertexFormat() const { return vertexFormat; }
+		//maps packed positions back to model space, identity for VertexFormat::Full
+		const glm::mat4& getDequantizeMatrix() const { return dequantizeMatrix; }
 
 	private:
-		void createVertexBuffers(const std::vector<Vertex> &vertices);
+		void createVertexBuffers(const void* vertices, uint32_t vertexSize, uint32_t count);
 		void createIndexBuffers(const std::vector<uint32_t>& indices);
 
 		LveDevice &lveDevice;
+		LveGeometryPool* geometryPool;
+
+		//pooled models draw with these added to their vertex and index offsets, both stay 0 for own buffers
+		LveGeometryPool::Range vertexRange{};
+		LveGeometryPool::Range indexRange{};
+		int32_t baseVertex = 0;
+		uint32_t baseIndex = 0;
 
 		std::unique_ptr<LveBuffer> vertexBuffer;
 		uint32_t vertexCount;
+		VertexFormat vertexFormat = VertexFormat::Full;
+		glm::mat4 dequantizeMatrix{ 1.f };
 		
 		bool hasIndexBuffer = false;
 		std::unique_ptr<LveBuffer> indexBuffer;
 		uint32_t indexCount;
+		VkIndexType indexType = VK_INDEX_TYPE_UINT32;	//UINT16 whenever every vertex is addressable with 16 bits
+		std::vector<Lod> lods;
+
+		glm::vec3 boundsCenter{};
+		float boundsRadius = 0.f;
+
+		MeshletData meshlets;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "lve_model_loader.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace lve
+{
+	LveModelLoader::LveModelLoader(LveDevice& device, LveGeometryPool* geometryPool, LveThreadPool& threadPool) 
+		: lveDevice{ device }, geometryPool{ geometryPool }, threadPool{ threadPool } {}
+
+	LveModelLoader::~LveModelLoader()
+	{
+		//decode tasks push into this loader, so none of them may outlive it
+		std::unique_lock<std::mutex> lock{ mutex };
+		decodesDone.wait(lock, [this] { return pendingDecodes == 0; });
+	}
+
+	LveModelLoader::Handle LveModelLoader::load(const std::string& filepath, const ModelImportOptions& options)
+	{
+		auto state = std::make_shared<LoadState>();
+		state->filepath = filepath;
+		state->options = options;
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			pendingDecodes++;
+		}
+
+		threadPool.submit([this, state]
+			{
+				try
+				{
+					state->builder.loadModel(state->filepath, state->options);
+				}
+				catch (...)
+				{
+					state->error = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock{ mutex };
+				decoded.push_back(state);
+				pendingDecodes--;
+				decodesDone.notify_all();
+			});
+
+		return Handle{ state };
+	}
+
+	void LveModelLoader::attach(const Handle& handle, LveGameObject::id_t gameObjectId)
+	{
+		assert(handle.isValid() && "Cannot attach an empty model handle");
+
+		std::lock_guard<std::mutex> lock{ mutex };
+		handle.state->targets.push_back(gameObjectId);
+		if (handle.isReady())
+		{
+			//already uploaded, queue it again so the next update() hands the model out
+			decoded.push_back(handle.state);
+		}
+	}
+
+	void LveModelLoader::update(LveGameObject::Map& gameObjects)
+	{
+		LveStagingRing& stagingRing = lveDevice.stagingRing();
+		while (!uploading.empty() && stagingRing.isComplete(uploading.front()->ticket))
+		{
+			uploading.front()->ready = true;
+			assignTargets(*uploading.front(), gameObjects);
+			uploading.pop_front();
+		}
+
+		std::vector<std::shared_ptr<LoadState>> batch;
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			size_t count = std::min<size_t>(decoded.size(), maxUploadsPerUpdate);
+			batch.assign(decoded.begin(), decoded.begin() + count);
+			decoded.erase(decoded.begin(), decoded.begin() + count);
+		}
+
+		//a failed load stops the batch, but what came before it is still submitted and what comes after stays queued,
+		//so every other handle still becomes ready
+		size_t newUploads = 0;
+		std::shared_ptr<LoadState> failed;
+		size_t processed = 0;
+		while (processed < batch.size() && !failed)
+		{
+			auto& state = batch[processed++];
+			if (!state->error && state->ready)
+			{
+				assignTargets(*state, gameObjects);
+				continue;
+			}
+
+			if (!state->error)
+			{
+				try
+				{
+					state->model = std::make_shared<LveModel>(lveDevice, state->builder, geometryPool);
+				}
+				catch (...)
+				{
+					state->error = std::current_exception();
+				}
+			}
+			if (state->error)
+			{
+				failed = state;
+				continue;
+			}
+
+			state->builder = LveModel::Builder{};
+			uploading.push_back(state);
+			newUploads++;
+		}
+
+		if (processed < batch.size())
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			decoded.insert(decoded.begin(), batch.begin() + processed, batch.end());
+		}
+
+		//the uploads of the whole batch go to the GPU in one submission, their models are handed out once it completes
+		LveStagingRing::Ticket ticket = stagingRing.submit();
+		for (size_t i = uploading.size() - newUploads; i < uploading.size(); i++)
+		{
+			uploading[i]->ticket = ticket;
+		}
+
+		if (failed)
+		{
+			try
+			{
+				std::rethrow_exception(failed->error);
+			}
+			catch (const std::exception& e)
+			{
+				throw std::runtime_error("failed to load model " + failed->filepath + ": " + e.what());
+			}
+		}
+	}
+
+	void LveModelLoader::assignTargets(LoadState& state, LveGameObject::Map& gameObjects)
+	{
+		std::vector<LveGameObject::id_t> targets;
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			targets.swap(state.targets);
+		}
+
+		for (auto id : targets)
+		{
+			auto gameObject = gameObjects.find(id);
+			if (gameObject != gameObjects.end())
+			{
+				gameObject->second.model = state.model;
+			}
+		}
+	}
+
+	bool LveModelLoader::isIdle()
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		return pendingDecodes == 0 && decoded.empty() && uploading.empty();
+	}
+}
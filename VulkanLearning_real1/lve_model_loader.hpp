@@ -0,0 +1,91 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_game_object.hpp"
+#include "lve_geometry_pool.hpp"
+#include "lve_model.hpp"
+#include "lve_staging_ring.hpp"
+#include "lve_thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lve
+{
+	// Decodes models on a thread pool and uploads them on the render thread, so loading never blocks the first frame.
+	// Game objects attached to a pending load keep a null model (and are skipped when drawing) until the staging batch
+	// holding its upload has completed.
+	class LveModelLoader
+	{
+		struct LoadState
+		{
+			std::string filepath;
+			ModelImportOptions options{};
+			LveModel::Builder builder{};
+			std::shared_ptr<LveModel> model{};
+			LveStagingRing::Ticket ticket = 0;	//of the batch holding the upload
+			std::exception_ptr error{};
+			std::vector<LveGameObject::id_t> targets{};
+			std::atomic<bool> ready{ false };
+		};
+
+	public:
+		class Handle
+		{
+		public:
+			Handle() = default;
+
+			bool isValid() const { return state != nullptr; }
+			bool isReady() const { return state && state->ready.load(); }
+			//null until isReady()
+			std::shared_ptr<LveModel> getModel() const { return isReady() ? state->model : nullptr; }
+
+		private:
+			Handle(std::shared_ptr<LoadState> state) : state{ std::move(state) } {}
+
+			std::shared_ptr<LoadState> state;
+
+			friend class LveModelLoader;
+		};
+
+		//models are uploaded into geometryPool when one is given
+		LveModelLoader(LveDevice& device, LveGeometryPool* geometryPool = nullptr, LveThreadPool& threadPool = LveThreadPool::shared());
+		~LveModelLoader();
+
+		LveModelLoader(const LveModelLoader&) = delete;
+		LveModelLoader& operator=(const LveModelLoader&) = delete;
+
+		//returns immediately, the file is decoded in the background
+		Handle load(const std::string& filepath, const ModelImportOptions& options = ModelImportOptions{});
+		//the game object gets the model assigned by update() once its upload has completed
+		void attach(const Handle& handle, LveGameObject::id_t gameObjectId);
+
+		//call once per frame from the render thread, uploads at most maxUploadsPerUpdate decoded models and hands out
+		//the ones whose upload has completed. Throws for a model that failed to load, after submitting the ones before
+		//it, the ones after it are uploaded by the next call
+		void update(LveGameObject::Map& gameObjects);
+		bool isIdle();
+
+		uint32_t maxUploadsPerUpdate = 4;
+
+	private:
+		//gives the model to every game object attached so far
+		void assignTargets(LoadState& state, LveGameObject::Map& gameObjects);
+
+		LveDevice& lveDevice;
+		LveGeometryPool* geometryPool;
+		LveThreadPool& threadPool;
+
+		std::mutex mutex;
+		std::condition_variable decodesDone;
+		uint32_t pendingDecodes = 0;
+		std::vector<std::shared_ptr<LoadState>> decoded;
+		std::deque<std::shared_ptr<LoadState>> uploading;	//render thread only, in ticket order
+	};
+}
@@ -0,0 +1,76 @@
+#include "lve_model_registry.hpp"
+#include "lve_utils.hpp"
+
+#include <filesystem>
+#include <iostream>
+
+namespace lve
+{
+	size_t LveModelRegistry::KeyHash::operator()(const Key& key) const
+	{
+		size_t seed = 0;
+		hashCombine(seed, key.filepath, key.options.hash());
+		return seed;
+	}
+
+	LveModelRegistry::LveModelRegistry(LveModelLoader& modelLoader) : modelLoader{ modelLoader } {}
+
+	LveModelLoader::Handle LveModelRegistry::load(const std::string& filepath, const ModelImportOptions& options)
+	{
+		//"models/x.obj" and "models/./x.obj" are the same asset
+		Key key{ std::filesystem::path{ filepath }.lexically_normal().generic_string(), options };
+
+		auto entry = entries.find(key);
+		if (entry != entries.end())
+		{
+			stats.hits++;
+			return entry->second;
+		}
+
+		stats.misses++;
+		auto handle = modelLoader.load(key.filepath, options);
+		entries.emplace(std::move(key), handle);
+		return handle;
+	}
+
+	void LveModelRegistry::attach(const std::string& filepath, LveGameObject::id_t gameObjectId, const ModelImportOptions& options)
+	{
+		modelLoader.attach(load(filepath, options), gameObjectId);
+	}
+
+	size_t LveModelRegistry::evictUnused()
+	{
+		size_t evicted = 0;
+		for (auto entry = entries.begin(); entry != entries.end();)
+		{
+			//the handle's load state owns one reference and the copy here is the second, any more belong to game objects
+			auto model = entry->second.getModel();
+			if (model && model.use_count() <= 2)
+			{
+				entry = entries.erase(entry);
+				evicted++;
+			}
+			else
+			{
+				++entry;
+			}
+		}
+
+		stats.evictions += evicted;
+		return evicted;
+	}
+
+	LveModelRegistry::Stats LveModelRegistry::getStats() const
+	{
+		Stats current = stats;
+		current.residentModels = entries.size();
+		return current;
+	}
+
+	void LveModelRegistry::logStats() const
+	{
+		Stats current = getStats();
+		std::cout << "model registry: " << current.residentModels << " resident, " << current.hits << " hits, "
+			<< current.misses << " misses, " << current.evictions << " evicted" << std::endl;
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "lve_model.hpp"
+#include "lve_model_loader.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace lve
+{
+	// Hands out one shared model per (path, import options), so a scene that places the same OBJ many times
+	// only decodes and uploads it once. Models stay resident until evictUnused() finds nobody else holding them.
+	class LveModelRegistry
+	{
+	public:
+		struct Stats
+		{
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictions = 0;
+			size_t residentModels = 0;
+		};
+
+		LveModelRegistry(LveModelLoader& modelLoader);
+
+		LveModelRegistry(const LveModelRegistry&) = delete;
+		LveModelRegistry& operator=(const LveModelRegistry&) = delete;
+
+		//an already requested model returns the existing handle, even if it is still loading
+		LveModelLoader::Handle load(const std::string& filepath, const ModelImportOptions& options = ModelImportOptions{});
+		//shorthand for loader.attach(load(...), id)
+		void attach(const std::string& filepath, LveGameObject::id_t gameObjectId, const ModelImportOptions& options = ModelImportOptions{});
+
+		//drops uploaded models that no game object references anymore, returns how many were dropped. Cheap enough to
+		//call periodically or on scene changes, FirstApp does it every MEMORY_LOG_INTERVAL
+		size_t evictUnused();
+
+		Stats getStats() const;
+		void logStats() const;
+
+	private:
+		struct Key
+		{
+			std::string filepath;
+			ModelImportOptions options;
+
+			bool operator ==(const Key& other) const { return filepath == other.filepath && options == other.options; }
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const;
+		};
+
+		LveModelLoader& modelLoader;
+
+		std::unordered_map<Key, LveModelLoader::Handle, KeyHash> entries;
+		Stats stats{};
+	};
+}
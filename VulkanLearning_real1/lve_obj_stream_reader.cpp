@@ -0,0 +1,318 @@
+#include "lve_obj_stream_reader.hpp"
+#include "lve_obj_tokenizer.hpp"
+#include "lve_vertex_welder.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace lve
+{
+	static inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	static inline const char* skipSpaces(const char* cursor, const char* end)
+	{
+		while (cursor < end && isSpace(*cursor)) cursor++;
+		return cursor;
+	}
+
+	// Everything read so far, one instance per file. Faces are either welded straight into vertices and indices or,
+	// when corners is set, triangulated into raw corner index triples for the caller to weld
+	class ObjStreamState
+	{
+	public:
+		ObjStreamState(const std::string& filepath, tinyobj::attrib_t& attrib, std::vector<tinyobj::index_t>* corners,
+			std::vector<LveModel::Vertex>* vertices, std::vector<uint32_t>* indices)
+			: filepath{ filepath }, attrib{ attrib }, corners{ corners }, vertices{ vertices }, indices{ indices }, welder{ 1 << 16 } {}
+
+		void parseLine(const char* cursor, const char* end)
+		{
+			lineNumber++;
+			cursor = skipSpaces(cursor, end);
+			if (end - cursor < 2)
+			{
+				return;
+			}
+
+			if (cursor[0] == 'v' && isSpace(cursor[1]))
+			{
+				parseVertex(cursor + 2, end);
+			}
+			else if (cursor[0] == 'v' && cursor[1] == 'n' && end - cursor > 2 && isSpace(cursor[2]))
+			{
+				parseFloats(cursor + 3, end, attrib.normals, 3);
+			}
+			else if (cursor[0] == 'v' && cursor[1] == 't' && end - cursor > 2 && isSpace(cursor[2]))
+			{
+				parseFloats(cursor + 3, end, attrib.texcoords, 2);
+			}
+			else if (cursor[0] == 'f' && isSpace(cursor[1]))
+			{
+				parseFace(cursor + 2, end);
+			}
+		}
+
+	private:
+		void parseVertex(const char* cursor, const char* end)
+		{
+			//one past x y z r g b, so a longer line isn't mistaken for a colored vertex
+			float values[7] = { 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 0.f };
+			int count = 0;
+			while (count < 7)
+			{
+				const char* next = LveObjTokenizer::parseFloat(cursor, end, values[count]);
+				if (next == nullptr) break;
+				cursor = next;
+				count++;
+			}
+			if (count < 3)
+			{
+				fail("vertex needs three coordinates");
+			}
+
+			//only exactly six values are x y z r g b, anything else (such as a w after the position) leaves the
+			//vertex white like tinyobj
+			attrib.vertices.insert(attrib.vertices.end(), values, values + 3);
+			if (count == 6)
+			{
+				attrib.colors.insert(attrib.colors.end(), values + 3, values + 6);
+			}
+			else
+			{
+				attrib.colors.insert(attrib.colors.end(), { 1.f, 1.f, 1.f });
+			}
+		}
+
+		void parseFloats(const char* cursor, const char* end, std::vector<float>& out, int count)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				float value = 0.f;
+				const char* next = LveObjTokenizer::parseFloat(cursor, end, value);
+				if (next == nullptr)
+				{
+					fail("attribute has too few components");
+				}
+				cursor = next;
+				out.push_back(value);
+			}
+		}
+
+		//1 based, negative counts back from the last element read so far
+		int64_t resolveIndex(int64_t index, size_t count)
+		{
+			int64_t resolved = index > 0 ? index - 1 : static_cast<int64_t>(count) + index;
+			if (index == 0 || resolved < 0 || resolved >= static_cast<int64_t>(count))
+			{
+				fail("face index out of range");
+			}
+			return resolved;
+		}
+
+		void parseFace(const char* cursor, const char* end)
+		{
+			polygon.clear();
+
+			while (true)
+			{
+				cursor = skipSpaces(cursor, end);
+				if (cursor >= end) break;
+
+				//v, v/t, v//n or v/t/n
+				int64_t v = 0, t = 0, n = 0;
+				cursor = LveObjTokenizer::parseInt(cursor, end, v);
+				if (cursor == nullptr)
+				{
+					fail("malformed face corner");
+				}
+				if (cursor < end && *cursor == '/')
+				{
+					cursor++;
+					if (cursor < end && *cursor != '/')
+					{
+						cursor = LveObjTokenizer::parseInt(cursor, end, t);
+						if (cursor == nullptr) fail("malformed texture index");
+					}
+					if (cursor < end && *cursor == '/')
+					{
+						cursor = LveObjTokenizer::parseInt(cursor + 1, end, n);
+						if (cursor == nullptr) fail("malformed normal index");
+					}
+				}
+
+				tinyobj::index_t corner{};
+				corner.vertex_index = static_cast<int>(resolveIndex(v, attrib.vertices.size() / 3));
+				corner.normal_index = n != 0 ? static_cast<int>(resolveIndex(n, attrib.normals.size() / 3)) : -1;
+				corner.texcoord_index = t != 0 ? static_cast<int>(resolveIndex(t, attrib.texcoords.size() / 2)) : -1;
+				polygon.push_back(corner);
+			}
+
+			if (polygon.size() < 3)
+			{
+				fail("face needs at least three corners");
+			}
+
+			triangulate();
+			if (corners != nullptr)
+			{
+				for (uint32_t corner : triangles)
+				{
+					corners->push_back(polygon[corner]);
+				}
+				return;
+			}
+
+			welded.clear();
+			for (const tinyobj::index_t& corner : polygon)
+			{
+				welded.push_back(welder.weld(makeVertex(corner), *vertices));
+			}
+			for (uint32_t corner : triangles)
+			{
+				indices->push_back(welded[corner]);
+			}
+		}
+
+		//polygon corners of each triangle, split the way tinyobj::LoadObj does for triangles and quads: a quad along
+		//its shorter diagonal, computed in float like tinyobj. Larger polygons are fanned, tinyobj clips ears there
+		void triangulate()
+		{
+			triangles.clear();
+			if (polygon.size() == 4)
+			{
+				const float* v0 = &attrib.vertices[static_cast<size_t>(polygon[0].vertex_index) * 3];
+				const float* v1 = &attrib.vertices[static_cast<size_t>(polygon[1].vertex_index) * 3];
+				const float* v2 = &attrib.vertices[static_cast<size_t>(polygon[2].vertex_index) * 3];
+				const float* v3 = &attrib.vertices[static_cast<size_t>(polygon[3].vertex_index) * 3];
+
+				float e02x = v2[0] - v0[0], e02y = v2[1] - v0[1], e02z = v2[2] - v0[2];
+				float e13x = v3[0] - v1[0], e13y = v3[1] - v1[1], e13z = v3[2] - v1[2];
+				float sqr02 = e02x * e02x + e02y * e02y + e02z * e02z;
+				float sqr13 = e13x * e13x + e13y * e13y + e13z * e13z;
+
+				if (sqr02 < sqr13)
+				{
+					triangles.insert(triangles.end(), { 0, 1, 2, 0, 2, 3 });
+				}
+				else
+				{
+					triangles.insert(triangles.end(), { 0, 1, 3, 1, 2, 3 });
+				}
+				return;
+			}
+
+			for (uint32_t i = 1; i + 1 < polygon.size(); i++)
+			{
+				triangles.insert(triangles.end(), { 0, i, i + 1 });
+			}
+		}
+
+		LveModel::Vertex makeVertex(const tinyobj::index_t& corner) const
+		{
+			const size_t position = static_cast<size_t>(corner.vertex_index);
+
+			LveModel::Vertex vertex{};
+			vertex.position = { attrib.vertices[position * 3 + 0], attrib.vertices[position * 3 + 1], attrib.vertices[position * 3 + 2] };
+			vertex.color = { attrib.colors[position * 3 + 0], attrib.colors[position * 3 + 1], attrib.colors[position * 3 + 2] };
+
+			if (corner.normal_index >= 0)
+			{
+				const size_t normal = static_cast<size_t>(corner.normal_index);
+				vertex.normal = { attrib.normals[normal * 3 + 0], attrib.normals[normal * 3 + 1], attrib.normals[normal * 3 + 2] };
+			}
+
+			if (corner.texcoord_index >= 0)
+			{
+				const size_t texcoord = static_cast<size_t>(corner.texcoord_index);
+				vertex.uv = { attrib.texcoords[texcoord * 2 + 0], 1.f - attrib.texcoords[texcoord * 2 + 1] };
+			}
+			return vertex;
+		}
+
+		[[noreturn]] void fail(const char* reason)
+		{
+			throw std::runtime_error(filepath + ":" + std::to_string(lineNumber) + ": " + reason);
+		}
+
+		const std::string& filepath;
+		tinyobj::attrib_t& attrib;
+		std::vector<tinyobj::index_t>* corners;
+		std::vector<LveModel::Vertex>* vertices;
+		std::vector<uint32_t>* indices;
+		LveVertexWelder welder;
+
+		std::vector<tinyobj::index_t> polygon;
+		std::vector<uint32_t> triangles;
+		std::vector<uint32_t> welded;
+		size_t lineNumber = 0;
+	};
+
+	static void readLines(const std::string& filepath, ObjStreamState& state)
+	{
+		std::ifstream file{ filepath, std::ios::binary };
+		if (!file.is_open())
+		{
+			throw std::runtime_error("failed to open file: " + filepath);
+		}
+
+		//a line split by the block boundary is moved to the front and completed by the next read
+		std::vector<char> buffer(LveObjStreamReader::BLOCK_SIZE);
+		size_t carried = 0;
+
+		while (true)
+		{
+			if (carried == buffer.size())
+			{
+				buffer.resize(buffer.size() * 2);
+			}
+
+			file.read(buffer.data() + carried, static_cast<std::streamsize>(buffer.size() - carried));
+			size_t filled = carried + static_cast<size_t>(file.gcount());
+			bool lastBlock = filled < buffer.size();
+
+			const char* cursor = buffer.data();
+			const char* end = buffer.data() + filled;
+			while (cursor < end)
+			{
+				const char* lineEnd = LveObjTokenizer::findLineEnd(cursor, end);
+				if (lineEnd == end && !lastBlock)
+				{
+					break;
+				}
+
+				state.parseLine(cursor, lineEnd);
+				cursor = lineEnd < end ? lineEnd + 1 : end;
+			}
+
+			if (lastBlock)
+			{
+				break;
+			}
+
+			carried = static_cast<size_t>(end - cursor);
+			std::memmove(buffer.data(), cursor, carried);
+		}
+	}
+
+	void LveObjStreamReader::read(const std::string& filepath, std::vector<LveModel::Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		vertices.clear();
+		indices.clear();
+
+		tinyobj::attrib_t attrib;
+		ObjStreamState state{ filepath, attrib, nullptr, &vertices, &indices };
+		readLines(filepath, state);
+	}
+
+	void LveObjStreamReader::readCorners(const std::string& filepath, tinyobj::attrib_t& attrib, std::vector<tinyobj::index_t>& corners)
+	{
+		attrib = tinyobj::attrib_t{};
+		corners.clear();
+
+		ObjStreamState state{ filepath, attrib, &corners, nullptr, nullptr };
+		readLines(filepath, state);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "lve_model.hpp"
+
+#include <tiny_obj_loader.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lve
+{
+	// OBJ importer for very large files, reads the file front to back in fixed size blocks and welds every face corner
+	// as soon as it is parsed. Only the raw v/vn/vt arrays are kept besides the output, there is no per shape index
+	// list and no copy of the whole file, so peak memory stays close to the size of the final vertex and index data.
+	// Triangles and quads come out as tinyobj::LoadObj triangulates them, larger polygons as fans. Groups, objects and
+	// materials are ignored. Numbers go through LveObjTokenizer, which rounds correctly where tinyobj may be an ulp off.
+	class LveObjStreamReader
+	{
+	public:
+		static constexpr size_t BLOCK_SIZE = 4 << 20;
+
+		//replaces the contents of vertices and indices, throws std::runtime_error on unreadable files or bad face indices
+		static void read(const std::string& filepath, std::vector<LveModel::Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		//the unwelded form tinyobj::LoadObj hands over, the raw attribute arrays and one index triple per triangle corner.
+		//Replaces the contents of attrib and corners, throws like read()
+		static void readCorners(const std::string& filepath, tinyobj::attrib_t& attrib, std::vector<tinyobj::index_t>& corners);
+	};
+}
\ No newline at end of file
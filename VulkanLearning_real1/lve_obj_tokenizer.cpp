@@ -0,0 +1,216 @@
+#include "lve_obj_tokenizer.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+#ifdef LVE_OBJ_TOKENIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace lve
+{
+	static constexpr float FLOAT_POWERS_OF_TEN[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+	static constexpr double DOUBLE_POWERS_OF_TEN[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	//the mantissa stays exact in a uint64_t up to 19 digits
+	static constexpr int MAX_FAST_DIGITS = 19;
+
+	static inline bool isDigit(char c)
+	{
+		return static_cast<unsigned char>(c - '0') < 10;
+	}
+
+	static inline bool isBlank(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	//eight ascii digits at once inside a 64 bit register (little endian)
+	static inline bool isEightDigits(uint64_t chunk)
+	{
+		return (((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+	}
+
+	static inline uint32_t parseEightDigits(uint64_t chunk)
+	{
+		constexpr uint64_t mask = 0x000000FF000000FFull;
+		constexpr uint64_t multiplier1 = 100 + (1000000ull << 32);
+		constexpr uint64_t multiplier2 = 1 + (10000ull << 32);
+
+		chunk -= 0x3030303030303030ull;
+		chunk = (chunk * 10) + (chunk >> 8);
+		chunk = (((chunk & mask) * multiplier1) + (((chunk >> 16) & mask) * multiplier2)) >> 32;
+		return static_cast<uint32_t>(chunk);
+	}
+
+	//appends a run of digits to mantissa, digits counts every digit seen even past MAX_FAST_DIGITS
+	static inline const char* accumulateDigits(const char* cursor, const char* end, uint64_t& mantissa, int& digits)
+	{
+		while (end - cursor >= 8 && digits + 8 <= MAX_FAST_DIGITS)
+		{
+			uint64_t chunk;
+			std::memcpy(&chunk, cursor, sizeof(chunk));
+			if (!isEightDigits(chunk)) break;
+
+			mantissa = mantissa * 100000000ull + parseEightDigits(chunk);
+			digits += 8;
+			cursor += 8;
+		}
+
+		while (cursor < end && isDigit(*cursor))
+		{
+			if (digits < MAX_FAST_DIGITS)
+			{
+				mantissa = mantissa * 10 + static_cast<uint64_t>(*cursor - '0');
+			}
+			digits++;
+			cursor++;
+		}
+		return cursor;
+	}
+
+	const char* LveObjTokenizer::findLineEnd(const char* cursor, const char* end)
+	{
+#ifdef LVE_OBJ_TOKENIZER_SSE2
+		const __m128i newline = _mm_set1_epi8('\n');
+		while (end - cursor >= 16)
+		{
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+			int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+			if (mask != 0)
+			{
+				return cursor + std::countr_zero(static_cast<unsigned int>(mask));
+			}
+			cursor += 16;
+		}
+#endif
+		return findLineEndScalar(cursor, end);
+	}
+
+	const char* LveObjTokenizer::findLineEndScalar(const char* cursor, const char* end)
+	{
+		while (cursor < end && *cursor != '\n') cursor++;
+		return cursor;
+	}
+
+	const char* LveObjTokenizer::parseFloat(const char* cursor, const char* end, float& value)
+	{
+		while (cursor < end && isBlank(*cursor)) cursor++;
+		if (cursor < end && *cursor == '+') cursor++;
+
+		const char* start = cursor;
+		bool negative = cursor < end && *cursor == '-';
+		if (negative) cursor++;
+
+		uint64_t mantissa = 0;
+		int digits = 0;
+		cursor = accumulateDigits(cursor, end, mantissa, digits);
+		int integerDigits = digits;
+
+		int exponent = 0;
+		if (cursor < end && *cursor == '.')
+		{
+			cursor = accumulateDigits(cursor + 1, end, mantissa, digits);
+			exponent = -(digits - integerDigits);
+		}
+
+		if (digits == 0 || digits > MAX_FAST_DIGITS)
+		{
+			//inf, nan, garbage or too many digits
+			return parseFloatScalar(start, end, value);
+		}
+
+		//an 'e' without digits after it is not part of the number
+		if (cursor < end && (*cursor == 'e' || *cursor == 'E'))
+		{
+			const char* exponentCursor = cursor + 1;
+			bool negativeExponent = false;
+			if (exponentCursor < end && (*exponentCursor == '-' || *exponentCursor == '+'))
+			{
+				negativeExponent = *exponentCursor == '-';
+				exponentCursor++;
+			}
+
+			if (exponentCursor < end && isDigit(*exponentCursor))
+			{
+				int exponentValue = 0;
+				while (exponentCursor < end && isDigit(*exponentCursor))
+				{
+					if (exponentValue > 1000) return parseFloatScalar(start, end, value);
+					exponentValue = exponentValue * 10 + (*exponentCursor - '0');
+					exponentCursor++;
+				}
+				exponent += negativeExponent ? -exponentValue : exponentValue;
+				cursor = exponentCursor;
+			}
+		}
+
+		float result;
+		if (mantissa == 0)
+		{
+			result = 0.f;
+		}
+		else if (mantissa <= (1ull << 24) && exponent >= -10 && exponent <= 10)
+		{
+			//both operands are exact floats, so the one rounding step is the correct one (Clinger's fast path)
+			result = static_cast<float>(mantissa);
+			result = exponent < 0 ? result / FLOAT_POWERS_OF_TEN[-exponent] : result * FLOAT_POWERS_OF_TEN[exponent];
+		}
+		else if (mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+		{
+			double exact = static_cast<double>(mantissa);
+			exact = exponent < 0 ? exact / DOUBLE_POWERS_OF_TEN[-exponent] : exact * DOUBLE_POWERS_OF_TEN[exponent];
+
+			//rounding the correctly rounded double again is only wrong when it landed exactly between two floats
+			uint64_t bits;
+			std::memcpy(&bits, &exact, sizeof(bits));
+			if ((bits & 0x1FFFFFFFull) == 0x10000000ull)
+			{
+				return parseFloatScalar(start, end, value);
+			}
+			result = static_cast<float>(exact);
+		}
+		else
+		{
+			return parseFloatScalar(start, end, value);
+		}
+
+		value = negative ? -result : result;
+		return cursor;
+	}
+
+	const char* LveObjTokenizer::parseFloatScalar(const char* cursor, const char* end, float& value)
+	{
+		while (cursor < end && isBlank(*cursor)) cursor++;
+		if (cursor < end && *cursor == '+') cursor++;
+
+		auto result = std::from_chars(cursor, end, value);
+		return result.ec == std::errc{} ? result.ptr : nullptr;
+	}
+
+	const char* LveObjTokenizer::parseInt(const char* cursor, const char* end, int64_t& value)
+	{
+		bool negative = cursor < end && *cursor == '-';
+		if (negative) cursor++;
+
+		const char* digitsStart = cursor;
+		int64_t result = 0;
+		while (cursor < end && isDigit(*cursor))
+		{
+			if (cursor - digitsStart >= 18) return nullptr;
+			result = result * 10 + (*cursor - '0');
+			cursor++;
+		}
+
+		if (cursor == digitsStart)
+		{
+			return nullptr;
+		}
+
+		value = negative ? -result : result;
+		return cursor;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LVE_OBJ_TOKENIZER_SSE2 1
+#endif
+
+namespace lve
+{
+	// Number and line scanning for the OBJ reader. Floats come out exactly as std::from_chars would round them,
+	// the fast paths only take inputs they can round correctly and hand everything else to from_chars.
+	class LveObjTokenizer
+	{
+	public:
+		//first '\n' in [cursor, end), or end; 16 bytes per step with SSE2
+		static const char* findLineEnd(const char* cursor, const char* end);
+
+		//skips leading blanks and an optional '+', returns nullptr when there is no number at cursor
+		static const char* parseFloat(const char* cursor, const char* end, float& value);
+		//signed decimal, no leading blanks, returns nullptr when there is no number at cursor
+		static const char* parseInt(const char* cursor, const char* end, int64_t& value);
+
+		//the plain scalar versions, kept for platforms without SSE2 and as a reference for the fast paths
+		static const char* findLineEndScalar(const char* cursor, const char* end);
+		static const char* parseFloatScalar(const char* cursor, const char* end, float& value);
+	};
+}
\ No newline at end of file
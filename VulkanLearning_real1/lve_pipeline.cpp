@@ -71,6 +71,23 @@ namespace lve
 		shaderStages[1].pNext = nullptr;
 		shaderStages[1].pSpecializationInfo = nullptr;
 
+		std::vector<VkSpecializationMapEntry> fragmentEntries(configInfo.fragmentConstants.size());
+		for (uint32_t i = 0; i < fragmentEntries.size(); i++)
+		{
+			fragmentEntries[i].constantID = i;
+			fragmentEntries[i].offset = i * sizeof(uint32_t);
+			fragmentEntries[i].size = sizeof(uint32_t);
+		}
+		VkSpecializationInfo fragmentSpecialization{};
+		fragmentSpecialization.mapEntryCount = static_cast<uint32_t>(fragmentEntries.size());
+		fragmentSpecialization.pMapEntries = fragmentEntries.data();
+		fragmentSpecialization.dataSize = configInfo.fragmentConstants.size() * sizeof(uint32_t);
+		fragmentSpecialization.pData = configInfo.fragmentConstants.data();
+		if (!fragmentEntries.empty())
+		{
+			shaderStages[1].pSpecializationInfo = &fragmentSpecialization;
+		}
+
 		auto& bindingDescriptions = configInfo.bindingDescriptions;
 		auto& attributeDescriptions = configInfo.attributeDescriptions;
 
@@ -1,4 +1,5 @@
 #include "lve_renderer.hpp"
+#include "lve_staging_ring.hpp"
 
 // std
 #include <array>
@@ -8,7 +9,9 @@
 namespace lve {
 
 LveRenderer::LveRenderer(LveWindow& window, LveDevice& device)
-    : lveWindow{window}, lveDevice{device} {
+    : lveWindow{window},
+      lveDevice{device},
+      frameAllocator{device, LveSwapChain::MAX_FRAMES_IN_FLIGHT} {
   recreateSwapChain();
   createCommandBuffers();
 }
@@ -74,6 +77,8 @@ VkCommandBuffer LveRenderer::beginFrame() {
   }
 
   isFrameStarted = true;
+  // acquireNextImage waited for this frame's fence, the GPU is done with its region
+  frameAllocator.beginFrame(currentFrameIndex);
 
   auto commandBuffer = getCurrentCommandBuffer();
   VkCommandBufferBeginInfo beginInfo{};
@@ -92,6 +97,11 @@ void LveRenderer::endFrame() {
     throw std::runtime_error("failed to record command buffer!");
   }
 
+  frameAllocator.flush();
+
+  // uploads recorded this frame have to be queued ahead of the frame that draws with them
+  lveDevice.stagingRing().submit();
+
   auto result = lveSwapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex);
   if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
       lveWindow.wasWindowResized()) {
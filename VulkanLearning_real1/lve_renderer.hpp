@@ -4,6 +4,7 @@
 #include "lve_device.hpp"
 #include "lve_swap_chain.hpp"
 #include "lve_model.hpp"
+#include "lve_frame_allocator.hpp"
 
 #include <cassert>
 #include <memory>
@@ -35,6 +36,9 @@ namespace lve
 			return currentFrameIndex; 
 		}
 
+		//per frame uniform and storage data, only valid to allocate from between beginFrame and endFrame
+		LveFrameAllocator& getFrameAllocator() { return frameAllocator; }
+
 		VkCommandBuffer beginFrame();
 		void endFrame();
 		void beginSwapChainRenderPass(VkCommandBuffer commandBuffer);
@@ -48,6 +52,7 @@ namespace lve
 
 		LveWindow& lveWindow;
 		LveDevice& lveDevice;
+		LveFrameAllocator frameAllocator;
 		std::unique_ptr<LveSwapChain> lveSwapChain;
 		std::vector<VkCommandBuffer> commandBuffers;
 
@@ -0,0 +1,504 @@
+#include "lve_staging_ring.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace lve
+{
+	LveStagingRing::LveStagingRing(LveDevice& device, VkDeviceSize size) : lveDevice{ device }, size{ size }
+	{
+		buffer = std::make_unique<LveBuffer>(lveDevice, size, 1,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+		buffer->map();
+
+		chunkSize = size / 4 / ALIGNMENT * ALIGNMENT;
+	}
+
+	LveStagingRing::~LveStagingRing()
+	{
+		waitIdle();
+
+		for (auto& submission : idle)
+		{
+			vkDestroyFence(lveDevice.device(), submission.fence, nullptr);
+			vkFreeCommandBuffers(lveDevice.device(), lveDevice.getTransferCommandPool(), 1, &submission.commandBuffer);
+			if (submission.acquireCommandBuffer != VK_NULL_HANDLE)
+			{
+				vkFreeCommandBuffers(lveDevice.device(), lveDevice.getCommandPool(), 1, &submission.acquireCommandBuffer);
+				vkDestroyFence(lveDevice.device(), submission.acquireFence, nullptr);
+				vkDestroySemaphore(lveDevice.device(), submission.semaphore, nullptr);
+			}
+		}
+	}
+
+	void LveStagingRing::uploadToBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize offset)
+	{
+		const char* source = static_cast<const char*>(data);
+
+		for (VkDeviceSize copied = 0; copied < size; copied += chunkSize)
+		{
+			VkDeviceSize bytes = std::min(chunkSize, size - copied);
+			VkDeviceSize ringOffset = reserve(bytes);
+			std::memcpy(static_cast<char*>(buffer->getMappedMemory()) + ringOffset, source + copied, bytes);
+
+			VkBufferCopy copyRegion{};
+			copyRegion.srcOffset = ringOffset;
+			copyRegion.dstOffset = offset + copied;
+			copyRegion.size = bytes;
+			vkCmdCopyBuffer(record(ringOffset), buffer->getBuffer(), dstBuffer, 1, &copyRegion);
+			releaseBuffer(dstBuffer, copyRegion.dstOffset, bytes);
+		}
+	}
+
+	void LveStagingRing::uploadToImage(const void* data, VkImage image, uint32_t width, uint32_t height, uint32_t texelSize,
+		uint32_t mipLevel, uint32_t blockExtent)
+	{
+		//rows of blocks for compressed formats, rows of texels otherwise
+		uint32_t blockRows = (height + blockExtent - 1) / blockExtent;
+		VkDeviceSize rowSize = static_cast<VkDeviceSize>((width + blockExtent - 1) / blockExtent) * texelSize;
+		assert(rowSize <= chunkSize && "Image rows must fit in a staging chunk");
+
+		const char* source = static_cast<const char*>(data);
+		uint32_t rowsPerChunk = static_cast<uint32_t>(chunkSize / rowSize);
+
+		for (uint32_t row = 0; row < blockRows; row += rowsPerChunk)
+		{
+			uint32_t rows = std::min(rowsPerChunk, blockRows - row);
+			VkDeviceSize bytes = rowSize * rows;
+			VkDeviceSize ringOffset = reserve(bytes);
+			std::memcpy(static_cast<char*>(buffer->getMappedMemory()) + ringOffset, source + rowSize * row, bytes);
+
+			VkBufferImageCopy region{};
+			region.bufferOffset = ringOffset;
+			region.bufferRowLength = 0;
+			region.bufferImageHeight = 0;
+
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = mipLevel;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+
+			//a partial block at the edge of the level is copied with the real size, not a multiple of the block
+			uint32_t firstTexelRow = row * blockExtent;
+			region.imageOffset = { 0, static_cast<int32_t>(firstTexelRow), 0 };
+			region.imageExtent = { width, std::min(rows * blockExtent, height - firstTexelRow), 1 };
+
+			vkCmdCopyBufferToImage(record(ringOffset), buffer->getBuffer(), image,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+		}
+	}
+
+	VkCommandBuffer LveStagingRing::getCommandBuffer()
+	{
+		if (recording)
+		{
+			return open.commandBuffer;
+		}
+
+		if (!idle.empty())
+		{
+			open = idle.back();
+			idle.pop_back();
+		}
+		else
+		{
+			open = createSubmission();
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(open.commandBuffer, &beginInfo);
+
+		recording = true;
+		openHasData = false;
+		return open.commandBuffer;
+	}
+
+	LveStagingRing::Submission LveStagingRing::createSubmission()
+	{
+		Submission submission{};
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		if (vkCreateFence(lveDevice.device(), &fenceInfo, nullptr, &submission.fence) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create staging fence!");
+		}
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = lveDevice.getTransferCommandPool();
+		allocInfo.commandBufferCount = 1;
+		if (vkAllocateCommandBuffers(lveDevice.device(), &allocInfo, &submission.commandBuffer) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to allocate staging command buffer!");
+		}
+
+		if (lveDevice.hasDedicatedTransferQueue())
+		{
+			VkSemaphoreCreateInfo semaphoreInfo{};
+			semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+			if (vkCreateSemaphore(lveDevice.device(), &semaphoreInfo, nullptr, &submission.semaphore) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create staging semaphore!");
+			}
+			if (vkCreateFence(lveDevice.device(), &fenceInfo, nullptr, &submission.acquireFence) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to create staging fence!");
+			}
+
+			allocInfo.commandPool = lveDevice.getCommandPool();
+			if (vkAllocateCommandBuffers(lveDevice.device(), &allocInfo, &submission.acquireCommandBuffer) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to allocate staging acquire command buffer!");
+			}
+		}
+		return submission;
+	}
+
+	void LveStagingRing::releaseBuffer(VkBuffer dstBuffer, VkDeviceSize offset, VkDeviceSize size)
+	{
+		if (!lveDevice.hasDedicatedTransferQueue())
+		{
+			return;
+		}
+
+		//chunks of one upload are contiguous, they share a barrier
+		if (!bufferReleases.empty() && bufferReleases.back().buffer == dstBuffer &&
+			bufferReleases.back().offset + bufferReleases.back().size == offset)
+		{
+			bufferReleases.back().size += size;
+			return;
+		}
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+		barrier.srcQueueFamilyIndex = lveDevice.transferQueueFamily();
+		barrier.dstQueueFamilyIndex = lveDevice.graphicsQueueFamily();
+		barrier.buffer = dstBuffer;
+		barrier.offset = offset;
+		barrier.size = size;
+		bufferReleases.push_back(barrier);
+	}
+
+	void LveStagingRing::releaseImage(VkImage image, const VkImageSubresourceRange& range, VkImageLayout newLayout,
+		VkAccessFlags dstAccessMask, VkPipelineStageFlags dstStageMask)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = newLayout;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = dstAccessMask;
+		barrier.image = image;
+		barrier.subresourceRange = range;
+
+		if (!lveDevice.hasDedicatedTransferQueue())
+		{
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			vkCmdPipelineBarrier(getCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask,
+				0, 0, nullptr, 0, nullptr, 1, &barrier);
+			return;
+		}
+
+		//the release goes after the image's copies, the acquire ahead of any graphics work that uses the image
+		barrier.srcQueueFamilyIndex = lveDevice.transferQueueFamily();
+		barrier.dstQueueFamilyIndex = lveDevice.graphicsQueueFamily();
+		vkCmdPipelineBarrier(getCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		barrier.srcAccessMask = 0;
+		vkCmdPipelineBarrier(getGraphicsCommandBuffer(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStageMask,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	VkCommandBuffer LveStagingRing::getGraphicsCommandBuffer()
+	{
+		VkCommandBuffer commandBuffer = getCommandBuffer();
+		if (!lveDevice.hasDedicatedTransferQueue())
+		{
+			return commandBuffer;
+		}
+
+		if (!acquireRecording)
+		{
+			VkCommandBufferBeginInfo beginInfo{};
+			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			vkBeginCommandBuffer(open.acquireCommandBuffer, &beginInfo);
+			acquireRecording = true;
+		}
+		return open.acquireCommandBuffer;
+	}
+
+	VkCommandBuffer LveStagingRing::record(VkDeviceSize offset)
+	{
+		VkCommandBuffer commandBuffer = getCommandBuffer();
+		if (!openHasData)
+		{
+			open.begin = offset;
+			openHasData = true;
+		}
+		return commandBuffer;
+	}
+
+	LveStagingRing::Ticket LveStagingRing::submit()
+	{
+		//runs every frame, so acquires of batches whose transfers have finished go out without anyone polling
+		submitAcquires();
+
+		if (!recording)
+		{
+			return lastSubmitted;
+		}
+
+		if (lveDevice.hasDedicatedTransferQueue())
+		{
+			submitOwnershipTransfer();
+		}
+		else
+		{
+			//nobody waits for the batch on the CPU, so later submissions need the barrier to see its writes
+			VkMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+			vkCmdPipelineBarrier(open.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+				0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+			vkEndCommandBuffer(open.commandBuffer);
+
+			VkSubmitInfo submitInfo{};
+			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			submitInfo.commandBufferCount = 1;
+			submitInfo.pCommandBuffers = &open.commandBuffer;
+
+			if (vkQueueSubmit(lveDevice.graphicsQueue(), 1, &submitInfo, open.fence) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to submit staging batch!");
+			}
+		}
+
+		//a batch without uploads holds an empty range at head, which keeps the ring order intact
+		if (!openHasData)
+		{
+			open.begin = head;
+		}
+		open.ticket = ++lastSubmitted;
+		inFlight.push_back(open);
+		recording = false;
+		openHasData = false;
+		return lastSubmitted;
+	}
+
+	LveStagingRing::Ticket LveStagingRing::getOpenTicket()
+	{
+		getCommandBuffer();
+		return lastSubmitted + 1;
+	}
+
+	void LveStagingRing::submitOwnershipTransfer()
+	{
+		//release on the transfer queue with a fence of its own, the graphics queue never waits for it
+		if (!bufferReleases.empty())
+		{
+			vkCmdPipelineBarrier(open.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+				0, nullptr,
+				static_cast<uint32_t>(bufferReleases.size()), bufferReleases.data(),
+				0, nullptr);
+		}
+		vkEndCommandBuffer(open.commandBuffer);
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &open.commandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &open.semaphore;
+
+		if (vkQueueSubmit(lveDevice.transferQueue(), 1, &submitInfo, open.fence) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to submit staging batch!");
+		}
+
+		//recorded now, submitAcquires() sends it once the fence has signaled. The acquire repeats each release, the release half of its access masks does nothing on this queue
+		VkCommandBuffer acquireCommandBuffer = getGraphicsCommandBuffer();
+		for (auto& barrier : bufferReleases)
+		{
+			barrier.srcAccessMask = 0;
+		}
+		if (!bufferReleases.empty())
+		{
+			vkCmdPipelineBarrier(acquireCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+				0, nullptr,
+				static_cast<uint32_t>(bufferReleases.size()), bufferReleases.data(),
+				0, nullptr);
+		}
+		vkEndCommandBuffer(acquireCommandBuffer);
+		acquireRecording = false;
+
+		bufferReleases.clear();
+	}
+
+	void LveStagingRing::submitAcquires()
+	{
+		//in batch order, so the acquire of a batch never overtakes the one of an older batch
+		for (auto& submission : inFlight)
+		{
+			if (submission.acquireCommandBuffer == VK_NULL_HANDLE || submission.acquireSubmitted)
+			{
+				continue;
+			}
+			if (vkGetFenceStatus(lveDevice.device(), submission.fence) != VK_SUCCESS)
+			{
+				return;
+			}
+
+			//the semaphore was signaled along with the fence, waiting on it costs nothing and consumes the signal
+			VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			VkSubmitInfo acquireInfo{};
+			acquireInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			acquireInfo.waitSemaphoreCount = 1;
+			acquireInfo.pWaitSemaphores = &submission.semaphore;
+			acquireInfo.pWaitDstStageMask = &waitStage;
+			acquireInfo.commandBufferCount = 1;
+			acquireInfo.pCommandBuffers = &submission.acquireCommandBuffer;
+
+			if (vkQueueSubmit(lveDevice.graphicsQueue(), 1, &acquireInfo, submission.acquireFence) != VK_SUCCESS)
+			{
+				throw std::runtime_error("failed to submit staging acquire!");
+			}
+			submission.acquireSubmitted = true;
+		}
+	}
+
+	bool LveStagingRing::isFinished(const Submission& submission) const
+	{
+		if (submission.acquireCommandBuffer == VK_NULL_HANDLE)
+		{
+			return vkGetFenceStatus(lveDevice.device(), submission.fence) == VK_SUCCESS;
+		}
+		return submission.acquireSubmitted && vkGetFenceStatus(lveDevice.device(), submission.acquireFence) == VK_SUCCESS;
+	}
+
+	bool LveStagingRing::isComplete(Ticket ticket)
+	{
+		reclaim(false);
+		return ticket <= lastCompleted;
+	}
+
+	void LveStagingRing::wait(Ticket ticket)
+	{
+		if (ticket > lastSubmitted)
+		{
+			submit();
+		}
+		while (lastCompleted < ticket && !inFlight.empty())
+		{
+			reclaim(true);
+		}
+	}
+
+	void LveStagingRing::waitIdle()
+	{
+		wait(submit());
+	}
+
+	VkDeviceSize LveStagingRing::reserve(VkDeviceSize size)
+	{
+		assert(size <= this->size && "Staging reservation is bigger than the ring");
+
+		reclaim(false);
+
+		VkDeviceSize offset;
+		while (!tryReserve(size, offset))
+		{
+			//only the open batch is left holding the ring, it has to go before its space can come back
+			if (inFlight.empty())
+			{
+				submit();
+			}
+			reclaim(true);
+		}
+
+		head = offset + size;
+		return offset;
+	}
+
+	bool LveStagingRing::tryReserve(VkDeviceSize size, VkDeviceSize& offset) const
+	{
+		if (inFlight.empty() && !openHasData)
+		{
+			offset = 0;
+			return true;
+		}
+
+		VkDeviceSize start = (head + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		VkDeviceSize tail = inFlight.empty() ? open.begin : inFlight.front().begin;
+
+		if (head > tail)
+		{
+			//used space is [tail, head), free space is behind it and, after wrapping, in front of it
+			if (start + size <= this->size)
+			{
+				offset = start;
+				return true;
+			}
+			if (size <= tail)
+			{
+				offset = 0;
+				return true;
+			}
+			return false;
+		}
+
+		//wrapped, used space is [tail, size) and [0, head), free space is [head, tail)
+		if (start + size <= tail)
+		{
+			offset = start;
+			return true;
+		}
+		return false;
+	}
+
+	void LveStagingRing::reclaim(bool waitForOldest)
+	{
+		if (waitForOldest && !inFlight.empty())
+		{
+			//on the transfer queue that is its transfers, then its acquire, which can only go out in between
+			Submission& oldest = inFlight.front();
+			vkWaitForFences(lveDevice.device(), 1, &oldest.fence, VK_TRUE, UINT64_MAX);
+			if (oldest.acquireCommandBuffer != VK_NULL_HANDLE)
+			{
+				submitAcquires();
+				vkWaitForFences(lveDevice.device(), 1, &oldest.acquireFence, VK_TRUE, UINT64_MAX);
+			}
+		}
+		submitAcquires();
+
+		while (!inFlight.empty() && isFinished(inFlight.front()))
+		{
+			Submission submission = inFlight.front();
+			inFlight.pop_front();
+			lastCompleted = submission.ticket;
+
+			vkResetFences(lveDevice.device(), 1, &submission.fence);
+			vkResetCommandBuffer(submission.commandBuffer, 0);
+			if (submission.acquireCommandBuffer != VK_NULL_HANDLE)
+			{
+				vkResetFences(lveDevice.device(), 1, &submission.acquireFence);
+				vkResetCommandBuffer(submission.acquireCommandBuffer, 0);
+				submission.acquireSubmitted = false;
+			}
+			idle.push_back(submission);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_buffer.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace lve
+{
+	// Persistently mapped upload buffer owned by LveDevice, and the batch its transfers are recorded into. Uploads and
+	// any other transfer work (layout transitions, blits) go into one open command buffer, submit() sends the whole
+	// batch with a single fence and returns a ticket to poll or wait on, nothing here drains the queue. Ring space is
+	// reclaimed once the fence of the batch that used it has signaled. Uploads bigger than a quarter of the ring go
+	// through in chunks, a full ring submits the open batch itself. Fences and command buffers are recycled, so a
+	// steady stream of uploads allocates nothing. Render thread only, like everything else that records commands.
+	// With a dedicated transfer queue the batch runs there with a fence of its own. Only once that has signaled does
+	// the ring send a small graphics submission acquiring ownership of everything the batch released, so the
+	// graphics queue never waits on the transfer queue and frames keep rendering while uploads are in flight. The
+	// ticket completes when the acquire has finished, attach what a batch uploaded only after isComplete().
+	class LveStagingRing
+	{
+	public:
+		//in submission order, a ticket is complete once its batch and every batch before it has finished
+		using Ticket = uint64_t;
+
+		static constexpr VkDeviceSize DEFAULT_SIZE = 32ull << 20;
+		//every chunk starts on this, a valid bufferOffset for all uncompressed and block compressed formats
+		static constexpr VkDeviceSize ALIGNMENT = 16;
+
+		LveStagingRing(LveDevice& device, VkDeviceSize size = DEFAULT_SIZE);
+		~LveStagingRing();
+
+		LveStagingRing(const LveStagingRing&) = delete;
+		LveStagingRing& operator=(const LveStagingRing&) = delete;
+
+		void uploadToBuffer(const void* data, VkDeviceSize size, VkBuffer buffer, VkDeviceSize offset = 0);
+		//image must be in TRANSFER_DST_OPTIMAL, chunks are split between rows of texels. Hand it to the graphics queue
+		//with releaseImage() once every level is written, buffers are handed over on their own. For block compressed
+		//formats texelSize is the size of a block and blockExtent its width and height in texels
+		void uploadToImage(const void* data, VkImage image, uint32_t width, uint32_t height, uint32_t texelSize,
+			uint32_t mipLevel = 0, uint32_t blockExtent = 1);
+
+		//the open batch, for recording barriers and copies of your own in between the uploads. It may belong to the
+		//transfer queue, so only transfer work and barriers with transfer stages go in here
+		VkCommandBuffer getCommandBuffer();
+		//the image must be in TRANSFER_DST_OPTIMAL and done being written by the batch. Moves it to newLayout for the
+		//graphics queue, which is a queue family ownership transfer when the batch runs on the transfer queue
+		void releaseImage(VkImage image, const VkImageSubresourceRange& range, VkImageLayout newLayout,
+			VkAccessFlags dstAccessMask, VkPipelineStageFlags dstStageMask);
+		//graphics queue work of the open batch (blits), it runs after the batch's transfers and sees every image
+		//released so far. The open batch itself when there is no dedicated transfer queue
+		VkCommandBuffer getGraphicsCommandBuffer();
+
+		//without a dedicated transfer queue the batch is visible to everything submitted to the graphics queue
+		//afterwards, with one only once its ticket is complete. Also sends the acquires of finished transfers, so call
+		//it every frame. With nothing recorded it returns the ticket of the last batch
+		Ticket submit();
+		//the ticket the open batch will get, opening an empty one if needed. Besides the batch it also covers everything
+		//the graphics queue was given before the batch goes out, so memory read by frames already submitted can be
+		//reused once it is complete
+		Ticket getOpenTicket();
+		bool isComplete(Ticket ticket);
+		//submits the open batch first when the ticket is still ahead of it
+		void wait(Ticket ticket);
+		//submits the open batch and blocks until everything has finished
+		void waitIdle();
+
+	private:
+		struct Submission
+		{
+			VkFence fence = VK_NULL_HANDLE;
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			//graphics side of a batch on the dedicated transfer queue, acquires the releases. Submitted once fence has
+			//signaled, acquireFence completes the ticket then
+			VkCommandBuffer acquireCommandBuffer = VK_NULL_HANDLE;
+			VkFence acquireFence = VK_NULL_HANDLE;
+			VkSemaphore semaphore = VK_NULL_HANDLE;
+			bool acquireSubmitted = false;
+			VkDeviceSize begin = 0;	//start of its ring space, which runs up to the next submission's begin
+			Ticket ticket = 0;
+		};
+
+		//space for size bytes, when the ring is full the open batch is submitted and the oldest one waited for
+		VkDeviceSize reserve(VkDeviceSize size);
+		bool tryReserve(VkDeviceSize size, VkDeviceSize& offset) const;
+		void reclaim(bool waitForOldest);
+		//the open batch, which now also holds the ring space at offset
+		VkCommandBuffer record(VkDeviceSize offset);
+		Submission createSubmission();
+		//hands a written buffer range to the graphics queue family
+		void releaseBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size);
+		void submitOwnershipTransfer();
+		//graphics submissions of the batches whose transfers have finished, oldest first
+		void submitAcquires();
+		bool isFinished(const Submission& submission) const;
+
+		LveDevice& lveDevice;
+		std::unique_ptr<LveBuffer> buffer;
+		VkDeviceSize size;
+		VkDeviceSize chunkSize;
+		VkDeviceSize head = 0;
+
+		Submission open{};
+		bool recording = false;
+		bool openHasData = false;	//whether open.begin marks ring space yet
+
+		//buffer ownership transfers of the open batch, recorded once at submit() so contiguous chunks share a barrier
+		std::vector<VkBufferMemoryBarrier> bufferReleases;
+		bool acquireRecording = false;
+
+		std::deque<Submission> inFlight;	//in submission order, so the oldest holds the tail of the ring
+		std::vector<Submission> idle;
+		Ticket lastSubmitted = 0;
+		Ticket lastCompleted = 0;
+	};
+}
\ No newline at end of file
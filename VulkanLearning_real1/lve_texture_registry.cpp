@@ -0,0 +1,168 @@
+#include "lve_texture_registry.hpp"
+#include "lve_staging_ring.hpp"
+#include "lve_thread_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+namespace lve
+{
+	LveTextureRegistry::LveTextureRegistry(LveDevice& device) : lveDevice{ device }
+	{
+		//a combined image sampler counts as both a sampler and a sampled image. The fragment stage's other resources
+		//are the global uniform buffer and the color attachment
+		const VkPhysicalDeviceLimits& limits = lveDevice.properties.limits;
+		capacity = std::min({ limits.maxPerStageDescriptorSamplers, limits.maxPerStageDescriptorSampledImages,
+			limits.maxDescriptorSetSamplers, limits.maxDescriptorSetSampledImages, MAX_CAPACITY });
+		capacity = std::min(capacity, limits.maxPerStageResources > 2 ? limits.maxPerStageResources - 2 : 0);
+		if (capacity == 0)
+		{
+			throw std::runtime_error("device can't bind enough textures for the texture registry!");
+		}
+	}
+
+	uint32_t LveTextureRegistry::load(const std::string& filepath)
+	{
+		return loadAll({ filepath }).front();
+	}
+
+	std::vector<uint32_t> LveTextureRegistry::loadAll(const std::vector<std::string>& filepaths)
+	{
+		std::vector<uint32_t> result(filepaths.size());
+
+		//paths not loaded yet, each once, with the index they are going to get
+		std::vector<std::string> pending;
+		std::unordered_map<std::string, uint32_t> pendingIndices;
+		for (size_t i = 0; i < filepaths.size(); i++)
+		{
+			auto it = indices.find(filepaths[i]);
+			if (it == indices.end())
+			{
+				it = pendingIndices.find(filepaths[i]);
+				if (it == pendingIndices.end())
+				{
+					it = pendingIndices.emplace(filepaths[i], static_cast<uint32_t>(textures.size() + pending.size())).first;
+					pending.push_back(filepaths[i]);
+				}
+			}
+			result[i] = it->second;
+		}
+
+		if (pending.empty())
+		{
+			return result;
+		}
+		if (textures.size() + pending.size() > capacity)
+		{
+			throw std::runtime_error("texture registry is full!");
+		}
+
+		auto start = std::chrono::steady_clock::now();
+
+		struct Decoded
+		{
+			uint32_t slot;
+			LveTextures::Source source;
+			std::exception_ptr error;
+		};
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<Decoded> decoded;
+
+		//decoding is most of the work and needs no GPU, recording stays on this thread like all other recording
+		for (uint32_t slot = 0; slot < pending.size(); slot++)
+		{
+			LveThreadPool::shared().submit([&, slot]()
+			{
+				Decoded item{ slot };
+				try
+				{
+					item.source = LveTextures::Source::read(lveDevice, pending[slot]);
+				}
+				catch (...)
+				{
+					item.error = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock{ mutex };
+				decoded.push_back(std::move(item));
+				condition.notify_one();
+			});
+		}
+
+		//uploads in the order decodes finish, so copying into the ring overlaps the ones still running. Every task
+		//is waited for even after an error, they all point into this stack frame
+		std::vector<std::unique_ptr<LveTextures>> loaded(pending.size());
+		std::exception_ptr firstError;
+		for (size_t received = 0; received < pending.size(); received++)
+		{
+			Decoded next;
+			{
+				std::unique_lock<std::mutex> lock{ mutex };
+				condition.wait(lock, [&]() { return !decoded.empty(); });
+				next = std::move(decoded.front());
+				decoded.pop_front();
+			}
+
+			if (next.error && !firstError)
+			{
+				firstError = next.error;
+			}
+			if (firstError)
+			{
+				continue;
+			}
+
+			try
+			{
+				loaded[next.slot] = std::make_unique<LveTextures>(lveDevice, next.source);
+			}
+			catch (...)
+			{
+				firstError = std::current_exception();
+			}
+		}
+
+		//the textures are only handed out once the batch has completed, on a dedicated transfer queue that is also
+		//when the graphics queue owns them. On error it may still be writing the ones that did get created
+		LveStagingRing& ring = lveDevice.stagingRing();
+		ring.wait(ring.submit());
+		if (firstError)
+		{
+			std::rethrow_exception(firstError);
+		}
+
+		for (uint32_t slot = 0; slot < pending.size(); slot++)
+		{
+			indices.emplace(pending[slot], static_cast<uint32_t>(textures.size()));
+			textures.push_back(std::move(loaded[slot]));
+		}
+
+		double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "Loaded " << pending.size() << " textures in " << milliseconds << " ms\n";
+		return result;
+	}
+
+	std::vector<VkDescriptorImageInfo> LveTextureRegistry::getDescriptorInfos() const
+	{
+		assert(!textures.empty() && "Texture registry needs a texture before it can be bound");
+
+		std::vector<VkDescriptorImageInfo> imageInfos(capacity);
+		for (uint32_t i = 0; i < capacity; i++)
+		{
+			LveTextures& texture = *textures[i < textures.size() ? i : 0];
+			imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			imageInfos[i].imageView = texture.getTextureImageView();
+			imageInfos[i].sampler = texture.getSampler();
+		}
+		return imageInfos;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_textures.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lve
+{
+	// Every texture the scene samples, behind one array of combined image samplers in the global set, as large as the
+	// device lets the fragment stage bind. Objects pick theirs with the index load() returns, passed in their push
+	// constants, so drawing with any of them needs no descriptor set switch. The set is written once, so all textures
+	// have to be loaded before that.
+	class LveTextureRegistry
+	{
+	public:
+		//array size simple_shader.frag declares, used when a pipeline doesn't specialize it with getCapacity()
+		static constexpr uint32_t DEFAULT_CAPACITY = 64;
+		//every element gets a descriptor written, so past this the array only costs set memory
+		static constexpr uint32_t MAX_CAPACITY = 4096;
+
+		//throws when the device can't bind a single sampler in the fragment stage
+		LveTextureRegistry(LveDevice& device);
+
+		LveTextureRegistry(const LveTextureRegistry&) = delete;
+		LveTextureRegistry& operator=(const LveTextureRegistry&) = delete;
+
+		//an already loaded path returns its existing index, throws once getCapacity() textures are loaded
+		uint32_t load(const std::string& filepath);
+		//index of every path, in order. New files are decoded in parallel on the shared thread pool, their uploads are
+		//recorded as each one finishes and go to the GPU as one staging batch, which is waited for before they are
+		//added. Throws the first decode error after the rest have finished, none of the batch is kept then
+		std::vector<uint32_t> loadAll(const std::vector<std::string>& filepaths);
+		uint32_t getTextureCount() const { return static_cast<uint32_t>(textures.size()); }
+		//size of the array binding, the samplers and sampled images the fragment stage and the global set can hold
+		//next to its uniform buffer and color attachment, at most MAX_CAPACITY. Passed to simple_shader.frag as
+		//specialization constant 0
+		uint32_t getCapacity() const { return capacity; }
+
+		//getCapacity() entries for the array binding, slots past the loaded textures repeat the first one so every
+		//element is valid. Needs at least one texture
+		std::vector<VkDescriptorImageInfo> getDescriptorInfos() const;
+
+	private:
+		LveDevice& lveDevice;
+		uint32_t capacity;
+		std::vector<std::unique_ptr<LveTextures>> textures;
+		std::unordered_map<std::string, uint32_t> indices;
+	};
+}
\ No newline at end of file
@@ -1,24 +1,79 @@
 #include "lve_textures.hpp"
+#include "lve_staging_ring.hpp"
+#include "lve_thread_pool.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <iostream>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <cstring>
+#include <filesystem>
 #include <stdexcept>
+#include <vector>
 
 
 namespace lve
 {
-	LveTextures::LveTextures(LveDevice& device, LveWindow& window) : lveDevice{device}
+	void LveTextures::Source::PixelDeleter::operator()(unsigned char* pixels) const
 	{
-		GLFWimage images[1];
-		images[0].pixels = stbi_load("./textures/NEEERDDDD.png", &images[0].width, &images[0].height, 0, 4); //rgba channels 
-		glfwSetWindowIcon(window.getGLFWwindow(), 1, images);
-		stbi_image_free(images[0].pixels);
+		stbi_image_free(pixels);
+	}
+
+	//a .dds converted before the source was last edited is stale, like a mesh cache whose stamp no longer matches.
+	//a .dds shipped without its source is always current
+	static bool isStale(const std::string& ddsPath, const std::string& sourcePath)
+	{
+		std::error_code error;
+		auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+		if (error)
+		{
+			return false;
+		}
+		auto ddsTime = std::filesystem::last_write_time(ddsPath, error);
+		return !error && sourceTime > ddsTime;
+	}
+
+	LveTextures::Source LveTextures::Source::read(LveDevice& device, const std::string& filepath)
+	{
+		Source source{};
+
+		std::string ddsPath = LveDdsTexture::pathFor(filepath);
+		auto dds = isStale(ddsPath, filepath) ? nullptr : std::make_unique<LveDdsTexture>(ddsPath);
+		if (dds && dds->isOpen() && device.hasTextureCompressionBC() &&
+			(device.getFormatProperties(dds->getFormat()).optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT))
+		{
+			source.width = dds->getWidth();
+			source.height = dds->getHeight();
+			source.dds = std::move(dds);
+			return source;
+		}
+
+		int texWidth, texHeight, texChannels;
+		source.pixels.reset(stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha));
+		if (!source.pixels)
+		{
+			throw std::runtime_error("failed to load texture image!");
+		}
+		source.width = static_cast<uint32_t>(texWidth);
+		source.height = static_cast<uint32_t>(texHeight);
+		return source;
+	}
+
+	LveTextures::LveTextures(LveDevice& device, const std::string& filepath)
+		: LveTextures{ device, Source::read(device, filepath) }
+	{
+		lveDevice.stagingRing().waitIdle();
 
-		createTextureImage();
+		std::cout << "Texture supposedly loaded :thumbsup:" << '\n';
+	}
+
+	LveTextures::LveTextures(LveDevice& device, const Source& source) : lveDevice{device}
+	{
+		createTextureImage(source);
 		createTextureImageView();
 		createTextureSampler();
 	}
@@ -27,55 +82,252 @@ namespace lve
 	{
 		vkDestroyImageView(lveDevice.device(), textureImageView, nullptr);
 
-		vkDestroyImage(lveDevice.device(), textureImage, nullptr);
+		lveDevice.destroyImage(textureImage, textureImageMemory);
 		vkDestroySampler(lveDevice.device(), textureSampler, nullptr);
+	}
 
-		vkFreeMemory(lveDevice.device(), textureImageMemory, nullptr);
+	void LveTextures::createTextureImage(const Source& source)
+	{
+		if (source.dds)
+		{
+			createCompressedTextureImage(*source.dds);
+			return;
+		}
+
+		const unsigned char* pixels = source.pixels.get();
+		uint32_t texWidth = source.width;
+		uint32_t texHeight = source.height;
+
+		//down to 1x1
+		mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+
+		//transfer src for the blits that fill the mip chain
+		LveTextures::createImage(texWidth, texHeight, mipLevels, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, 
+			VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, 
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
+
+		transitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, 
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+
+		//blits need linear filtering support for the format, which is optional
+		VkFormatProperties formatProperties = lveDevice.getFormatProperties(VK_FORMAT_R8G8B8A8_SRGB);
+		if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+		{
+			lveDevice.stagingRing().uploadToImage(pixels, textureImage, texWidth, texHeight, 4);
+			generateMipmaps(textureImage, static_cast<int32_t>(texWidth), static_cast<int32_t>(texHeight), mipLevels);
+		}
+		else
+		{
+			generateMipmapsCpu(pixels, textureImage, texWidth, texHeight, mipLevels);
+			transitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB,
+				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
+		}
 	}
 
-	void LveTextures::createTextureImage()
+	void LveTextures::createCompressedTextureImage(const LveDdsTexture& dds)
 	{
-		int texWidth, texHeight, texChannels;
-		stbi_uc* pixels = stbi_load("textures/IMG_5776.png", &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-		VkDeviceSize imageSize = texWidth * texHeight * 4;
+		textureFormat = dds.getFormat();
+		mipLevels = static_cast<uint32_t>(dds.getLevels().size());
 
-		if (!pixels) 
+		createImage(dds.getWidth(), dds.getHeight(), mipLevels, textureFormat, VK_IMAGE_TILING_OPTIMAL,
+			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
+
+		transitionImageLayout(textureImage, textureFormat, VK_IMAGE_LAYOUT_UNDEFINED,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
+
+		//straight from the mapped file into the ring, the blocks are already what the GPU samples
+		for (uint32_t i = 0; i < mipLevels; i++)
 		{
-			throw std::runtime_error("failed to load texture image!");
+			const LveDdsTexture::Level& level = dds.getLevels()[i];
+			lveDevice.stagingRing().uploadToImage(level.data, textureImage, level.width, level.height,
+				dds.getBlockSize(), i, LveDdsTexture::BLOCK_EXTENT);
 		}
 
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
+		transitionImageLayout(textureImage, textureFormat,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mipLevels);
+	}
 
-		lveDevice.createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, 
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+	void LveTextures::generateMipmaps(VkImage image, int32_t width, int32_t height, uint32_t mipLevels)
+	{
+		LveStagingRing& ring = lveDevice.stagingRing();
 
-		void* data;
-		vkMapMemory(lveDevice.device(), stagingBufferMemory, 0, imageSize, 0, &data);
-		memcpy(data, pixels, static_cast<size_t>(imageSize));
-		vkUnmapMemory(lveDevice.device(), stagingBufferMemory);
+		VkImageSubresourceRange range{};
+		range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		range.baseMipLevel = 0;
+		range.levelCount = mipLevels;
+		range.baseArrayLayer = 0;
+		range.layerCount = 1;
 
-		stbi_image_free(pixels);
+		//blits are graphics queue work, the ring hands the image over from the transfer queue when it has one
+		ring.releaseImage(image, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+		VkCommandBuffer commandBuffer = ring.getGraphicsCommandBuffer();
 
-		LveTextures::createImage(texWidth, texHeight, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, 
-			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, 
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange = range;
+		barrier.subresourceRange.levelCount = 1;
 
-		transitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-		lveDevice.copyBufferToImage(stagingBuffer, textureImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), 1);
-		
-		transitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, 
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		int32_t mipWidth = width;
+		int32_t mipHeight = height;
 
-		vkDestroyBuffer(lveDevice.device(), stagingBuffer, nullptr);
-		vkFreeMemory(lveDevice.device(), stagingBufferMemory, nullptr);
+		for (uint32_t i = 1; i < mipLevels; i++)
+		{
+			//the level above is written, by the upload or the previous blit, make it the blit source
+			barrier.subresourceRange.baseMipLevel = i - 1;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+			vkCmdPipelineBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+				0, nullptr,
+				0, nullptr,
+				1, &barrier);
+
+			int32_t nextWidth = mipWidth > 1 ? mipWidth / 2 : 1;
+			int32_t nextHeight = mipHeight > 1 ? mipHeight / 2 : 1;
+
+			VkImageBlit blit{};
+			blit.srcOffsets[0] = { 0, 0, 0 };
+			blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+			blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.srcSubresource.mipLevel = i - 1;
+			blit.srcSubresource.baseArrayLayer = 0;
+			blit.srcSubresource.layerCount = 1;
+			blit.dstOffsets[0] = { 0, 0, 0 };
+			blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+			blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.dstSubresource.mipLevel = i;
+			blit.dstSubresource.baseArrayLayer = 0;
+			blit.dstSubresource.layerCount = 1;
+
+			vkCmdBlitImage(commandBuffer,
+				image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				1, &blit, VK_FILTER_LINEAR);
+
+			//done as a source, it only gets sampled from here on
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
+			vkCmdPipelineBarrier(commandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+				0, nullptr,
+				0, nullptr,
+				1, &barrier);
 
-		std::cout << "Texture supposedly loaded :thumbsup:" << '\n';
+			mipWidth = nextWidth;
+			mipHeight = nextHeight;
+		}
+
+		//the last level is never a blit source
+		barrier.subresourceRange.baseMipLevel = mipLevels - 1;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier);
+	}
+
+	static float srgbToLinear(unsigned char value)
+	{
+		static const std::array<float, 256> table = []
+		{
+			std::array<float, 256> result{};
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				float c = static_cast<float>(i) / 255.f;
+				result[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			}
+			return result;
+		}();
+		return table[value];
+	}
+
+	static unsigned char linearToSrgb(float value)
+	{
+		float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+		return static_cast<unsigned char>(std::clamp(c * 255.f + 0.5f, 0.f, 255.f));
+	}
+
+	//2x2 box filter, averaged in linear space so the smaller levels don't darken. Odd sizes drop the last row or
+	//column, same as a blit does
+	static void downsampleSrgba(const unsigned char* src, uint32_t srcWidth, uint32_t srcHeight,
+		unsigned char* dst, uint32_t dstWidth, uint32_t dstHeight)
+	{
+		constexpr uint32_t ROWS_PER_TASK = 32;
+		uint32_t taskCount = (dstHeight + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+
+		LveThreadPool::shared().parallelFor(taskCount, [&](uint32_t task)
+		{
+			uint32_t rowEnd = std::min(dstHeight, (task + 1) * ROWS_PER_TASK);
+			for (uint32_t y = task * ROWS_PER_TASK; y < rowEnd; y++)
+			{
+				const unsigned char* row0 = src + static_cast<size_t>(std::min(y * 2, srcHeight - 1)) * srcWidth * 4;
+				const unsigned char* row1 = src + static_cast<size_t>(std::min(y * 2 + 1, srcHeight - 1)) * srcWidth * 4;
+				unsigned char* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+
+				for (uint32_t x = 0; x < dstWidth; x++)
+				{
+					uint32_t x0 = std::min(x * 2, srcWidth - 1) * 4;
+					uint32_t x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						float sum = srgbToLinear(row0[x0 + c]) + srgbToLinear(row0[x1 + c]) +
+							srgbToLinear(row1[x0 + c]) + srgbToLinear(row1[x1 + c]);
+						out[x * 4 + c] = linearToSrgb(sum * 0.25f);
+					}
+					//alpha is linear already
+					uint32_t alpha = row0[x0 + 3] + row0[x1 + 3] + row1[x0 + 3] + row1[x1 + 3];
+					out[x * 4 + 3] = static_cast<unsigned char>((alpha + 2) / 4);
+				}
+			}
+		});
+	}
+
+	void LveTextures::generateMipmapsCpu(const unsigned char* pixels, VkImage image, uint32_t width, uint32_t height,
+		uint32_t mipLevels)
+	{
+		LveStagingRing& ring = lveDevice.stagingRing();
+		ring.uploadToImage(pixels, image, width, height, 4);
+
+		//the ring copies every level out, so two scratch levels are enough
+		std::vector<unsigned char> current;
+		std::vector<unsigned char> next;
+		const unsigned char* source = pixels;
+
+		for (uint32_t i = 1; i < mipLevels; i++)
+		{
+			uint32_t nextWidth = std::max(width / 2, 1u);
+			uint32_t nextHeight = std::max(height / 2, 1u);
+
+			next.resize(static_cast<size_t>(nextWidth) * nextHeight * 4);
+			downsampleSrgba(source, width, height, next.data(), nextWidth, nextHeight);
+			ring.uploadToImage(next.data(), image, nextWidth, nextHeight, 4, i);
+
+			current.swap(next);
+			source = current.data();
+			width = nextWidth;
+			height = nextHeight;
+		}
 	}
 
-	void LveTextures::createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling,
-		VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
+	void LveTextures::createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, VkImageTiling tiling,
+		VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, LveAllocator::Allocation& imageMemory)
 	{
 		VkImageCreateInfo imageInfo{};
 		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -83,7 +335,7 @@ namespace lve
 		imageInfo.extent.width = width;
 		imageInfo.extent.height = height;
 		imageInfo.extent.depth = 1;
-		imageInfo.mipLevels = 1;
+		imageInfo.mipLevels = mipLevels;
 		imageInfo.arrayLayers = 1;
 		imageInfo.format = format;
 		imageInfo.tiling = tiling;
@@ -92,32 +344,31 @@ namespace lve
 		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT; //changed
 		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-		if (vkCreateImage(lveDevice.device(), &imageInfo, nullptr, &image) != VK_SUCCESS) 
-		{
-			throw std::runtime_error("failed to create image!");
-		}
-
-		VkMemoryRequirements memRequirements;
-		vkGetImageMemoryRequirements(lveDevice.device(), image, &memRequirements);
-
-		VkMemoryAllocateInfo allocInfo{};
-		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-		allocInfo.allocationSize = memRequirements.size;
-		allocInfo.memoryTypeIndex = lveDevice.findMemoryType(memRequirements.memoryTypeBits, properties);
-
-		if (vkAllocateMemory(lveDevice.device(), &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) 
-		{
-			throw std::runtime_error("failed to allocate image memory!");
-		}
-
-		vkBindImageMemory(lveDevice.device(), image, imageMemory, 0);
+		lveDevice.createImageWithInfo(imageInfo, properties, image, imageMemory);
 	}
 
 	//I had copybuffer here, but it already exists in lve_device
 	
-	void LveTextures::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) 
+	void LveTextures::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout,
+		uint32_t mipLevels) 
 	{
-		VkCommandBuffer commandBuffer = lveDevice.beginSingleTimeCommands();
+		VkImageSubresourceRange range{};
+		range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		range.baseMipLevel = 0;
+		range.levelCount = mipLevels;
+		range.baseArrayLayer = 0;
+		range.layerCount = 1;
+
+		//the upload may have run on the transfer queue, the ring hands the image over to the graphics queue
+		if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+		{
+			lveDevice.stagingRing().releaseImage(image, range, newLayout, VK_ACCESS_SHADER_READ_BIT,
+				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+			return;
+		}
+
+		//recorded into the staging batch, so the transitions and the upload go to the GPU in one submission
+		VkCommandBuffer commandBuffer = lveDevice.stagingRing().getCommandBuffer();
 
 		VkImageMemoryBarrier barrier{};
 		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -126,11 +377,7 @@ namespace lve
 		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
 		barrier.image = image;
-		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-		barrier.subresourceRange.baseMipLevel = 0;
-		barrier.subresourceRange.levelCount = 1;
-		barrier.subresourceRange.baseArrayLayer = 0;
-		barrier.subresourceRange.layerCount = 1;
+		barrier.subresourceRange = range;
 		barrier.srcAccessMask = 0; // TODO
 		barrier.dstAccessMask = 0; // TODO
 
@@ -144,13 +391,6 @@ namespace lve
 			sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 			destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 		}
-		else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-			sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-		}
 		else {
 			throw std::invalid_argument("unsupported layout transition!");
 		}
@@ -163,11 +403,9 @@ namespace lve
 			0, nullptr,
 			1, &barrier
 		);
-
-		lveDevice.endSingleTimeCommands(commandBuffer);
 	}
 
-	VkImageView LveTextures::createImageView(VkImage image, VkFormat format)
+	VkImageView LveTextures::createImageView(VkImage image, VkFormat format, uint32_t mipLevels)
 	{
 		VkImageViewCreateInfo viewInfo{};
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -176,7 +414,7 @@ namespace lve
 		viewInfo.format = format;
 		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.levelCount = mipLevels;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 1;
 
@@ -190,7 +428,7 @@ namespace lve
 
 	void LveTextures::createTextureImageView()
 	{
-		textureImageView = createImageView(textureImage, VK_FORMAT_R8G8B8A8_SRGB);
+		textureImageView = createImageView(textureImage, textureFormat, mipLevels);
 	}
 
 	void LveTextures::createTextureSampler()
@@ -215,7 +453,7 @@ namespace lve
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 		samplerInfo.mipLodBias = 0.0f;
 		samplerInfo.minLod = 0.0f;
-		samplerInfo.maxLod = 0.0f;
+		samplerInfo.maxLod = static_cast<float>(mipLevels);
 
 		if (vkCreateSampler(lveDevice.device(), &samplerInfo, nullptr, &textureSampler) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create texture sampler!");
@@ -4,27 +4,65 @@
 #include "lve_descriptors.hpp"
 #include "lve_model.hpp"
 #include "lve_buffer.hpp"
-#include "lve_window.hpp"
+#include "lve_dds.hpp"
+
+#include <memory>
+#include <string>
 
 namespace lve
 {
 	class LveTextures
 	{
 	public:
-		LveTextures(LveDevice& device, LveWindow& window);
+		// A texture file read into memory, everything that doesn't touch the GPU. Safe to read on any thread, so
+		// many files can be decoded in parallel and only the uploads recorded on the render thread
+		struct Source
+		{
+			struct PixelDeleter
+			{
+				void operator()(unsigned char* pixels) const;
+			};
+
+			//the pre-compressed .dds next to the file when the device can sample it and it is newer than the file, no
+			//pixels are decoded then
+			std::unique_ptr<LveDdsTexture> dds;
+			std::unique_ptr<unsigned char, PixelDeleter> pixels;	//RGBA8 sRGB
+			uint32_t width = 0;
+			uint32_t height = 0;
+
+			//throws when the file can't be decoded
+			static Source read(LveDevice& device, const std::string& filepath);
+		};
+
+		//reads the file and waits for its upload
+		LveTextures(LveDevice& device, const std::string& filepath);
+		//records the upload into the staging ring's open batch, the caller submits it
+		LveTextures(LveDevice& device, const Source& source);
 		~LveTextures();
 
-		void createTextureImage();
-		void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
-			VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory);
-		void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-		VkImageView createImageView(VkImage image, VkFormat format);
+		LveTextures(const LveTextures&) = delete;
+		LveTextures& operator=(const LveTextures&) = delete;
+
+		void createTextureImage(const Source& source);
+		//pre-compressed texture with its mips from the converter
+		void createCompressedTextureImage(const LveDdsTexture& dds);
+		void createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkFormat format, VkImageTiling tiling,
+			VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, LveAllocator::Allocation& imageMemory);
+		void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout,
+			uint32_t mipLevels = 1);
+		//level 0 must already be uploaded, leaves every level in SHADER_READ_ONLY_OPTIMAL. Needs a format with linear
+		//filtering for blits, see generateMipmapsCpu() otherwise
+		void generateMipmaps(VkImage image, int32_t width, int32_t height, uint32_t mipLevels);
+		//uploads every level of an RGBA8 sRGB image, each downsampled from the one above on the thread pool
+		void generateMipmapsCpu(const unsigned char* pixels, VkImage image, uint32_t width, uint32_t height,
+			uint32_t mipLevels);
+		VkImageView createImageView(VkImage image, VkFormat format, uint32_t mipLevels = 1);
 		void createTextureImageView();
 		void createTextureSampler();
 
 		//getter functions, used for destruction
 		VkImage& getTextureImage() { return textureImage; }
-		VkDeviceMemory& getTextureImageMemory() { return textureImageMemory; }
+		LveAllocator::Allocation& getTextureImageMemory() { return textureImageMemory; }
 		VkImageView& getTextureImageView() { return textureImageView; }
 		VkSampler& getSampler() { return textureSampler; }
 
@@ -32,7 +70,9 @@ namespace lve
 
 		LveDevice& lveDevice;
 		VkImage textureImage;
-		VkDeviceMemory textureImageMemory;
+		VkFormat textureFormat = VK_FORMAT_R8G8B8A8_SRGB;
+		uint32_t mipLevels = 1;
+		LveAllocator::Allocation textureImageMemory{};
 		VkImageCreateInfo imageInfo{};
 		VkImageView textureImageView;
 		VkSampler textureSampler;
@@ -0,0 +1,143 @@
+#include "lve_thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace lve
+{
+	LveThreadPool::LveThreadPool(uint32_t threadCount)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+
+		workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			workers.emplace_back([this] { workerLoop(); });
+		}
+	}
+
+	LveThreadPool::~LveThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			stopping = true;
+		}
+		condition.notify_all();
+
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	LveThreadPool& LveThreadPool::shared()
+	{
+		static LveThreadPool pool{};
+		return pool;
+	}
+
+	void LveThreadPool::submit(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			tasks.push_back(std::move(task));
+		}
+		condition.notify_one();
+	}
+
+	void LveThreadPool::workerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock{ mutex };
+				condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+				if (stopping && tasks.empty())
+				{
+					return;
+				}
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	void LveThreadPool::parallelFor(uint32_t count, const std::function<void(uint32_t)>& task)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		if (count == 1)
+		{
+			task(0);
+			return;
+		}
+
+		//helpers may start after this call returned (the caller drained every item), so they only touch shared state
+		struct Batch
+		{
+			const std::function<void(uint32_t)>* task;
+			uint32_t count;
+			std::atomic<uint32_t> next{ 0 };
+			std::atomic<uint32_t> finished{ 0 };
+			std::mutex mutex;
+			std::condition_variable done;
+			std::exception_ptr error;
+		};
+
+		auto batch = std::make_shared<Batch>();
+		batch->task = &task;
+		batch->count = count;
+
+		auto drain = [](Batch& batch)
+		{
+			uint32_t item;
+			while ((item = batch.next.fetch_add(1)) < batch.count)
+			{
+				try
+				{
+					(*batch.task)(item);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock{ batch.mutex };
+					if (!batch.error)
+					{
+						batch.error = std::current_exception();
+					}
+				}
+
+				if (batch.finished.fetch_add(1) + 1 == batch.count)
+				{
+					std::lock_guard<std::mutex> lock{ batch.mutex };
+					batch.done.notify_all();
+				}
+			}
+		};
+
+		uint32_t helpers = std::min(count - 1, getThreadCount());
+		for (uint32_t i = 0; i < helpers; i++)
+		{
+			submit([batch, drain] { drain(*batch); });
+		}
+
+		drain(*batch);
+
+		std::unique_lock<std::mutex> lock{ batch->mutex };
+		batch->done.wait(lock, [&] { return batch->finished.load() == batch->count; });
+
+		if (batch->error)
+		{
+			std::rethrow_exception(batch->error);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lve
+{
+	class LveThreadPool
+	{
+	public:
+		//threadCount of 0 uses one worker per hardware thread
+		LveThreadPool(uint32_t threadCount = 0);
+		~LveThreadPool();
+
+		LveThreadPool(const LveThreadPool&) = delete;
+		LveThreadPool& operator=(const LveThreadPool&) = delete;
+
+		void submit(std::function<void()> task);
+
+		//runs task(i) for every i in [0, count) on the workers and the calling thread, returns once all of them finished.
+		//safe to call from inside a pool task, the caller keeps pulling items itself instead of blocking on the workers
+		void parallelFor(uint32_t count, const std::function<void(uint32_t)>& task);
+
+		uint32_t getThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+		//process wide pool for import and decode work
+		static LveThreadPool& shared();
+
+	private:
+		void workerLoop();
+
+		std::vector<std::thread> workers;
+		std::deque<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool stopping = false;
+	};
+}
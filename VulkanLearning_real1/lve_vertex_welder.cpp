@@ -0,0 +1,104 @@
+#include "lve_vertex_welder.hpp"
+
+#include <cstring>
+
+namespace lve
+{
+	//equal vertices must hash equally, and Vertex::operator== treats -0.f and 0.f as equal
+	static inline uint32_t floatBits(float value)
+	{
+		if (value == 0.f)
+		{
+			return 0;
+		}
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	static inline uint32_t mixBits(uint32_t hash, uint32_t bits)
+	{
+		//murmur3 style block mix
+		bits *= 0xcc9e2d51u;
+		bits = (bits << 15) | (bits >> 17);
+		bits *= 0x1b873593u;
+		hash ^= bits;
+		hash = (hash << 13) | (hash >> 19);
+		return hash * 5 + 0xe6546b64u;
+	}
+
+	uint32_t LveVertexWelder::hashVertex(const LveModel::Vertex& vertex)
+	{
+		uint32_t hash = 0;
+		for (int i = 0; i < 3; i++) hash = mixBits(hash, floatBits(vertex.position[i]));
+		for (int i = 0; i < 3; i++) hash = mixBits(hash, floatBits(vertex.color[i]));
+		for (int i = 0; i < 3; i++) hash = mixBits(hash, floatBits(vertex.normal[i]));
+		for (int i = 0; i < 2; i++) hash = mixBits(hash, floatBits(vertex.uv[i]));
+
+		hash ^= hash >> 16;
+		hash *= 0x85ebca6bu;
+		hash ^= hash >> 13;
+		hash *= 0xc2b2ae35u;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	LveVertexWelder::LveVertexWelder(size_t maxVertices)
+	{
+		//keeps the load factor at or below 2/3 even if every vertex turns out to be unique
+		size_t capacity = 16;
+		while (capacity < maxVertices + maxVertices / 2)
+		{
+			capacity <<= 1;
+		}
+		slots.assign(capacity, EMPTY_SLOT);
+		slotMask = capacity - 1;
+	}
+
+	uint32_t LveVertexWelder::weld(const LveModel::Vertex& vertex, std::vector<LveModel::Vertex>& vertices)
+	{
+		if ((usedSlots + 1) * 3 > slots.size() * 2)
+		{
+			grow(vertices);
+		}
+
+		size_t slot = hashVertex(vertex) & slotMask;
+		while (slots[slot] != EMPTY_SLOT)
+		{
+			if (vertices[slots[slot]] == vertex)
+			{
+				return slots[slot];
+			}
+			slot = (slot + 1) & slotMask;
+		}
+
+		uint32_t index = static_cast<uint32_t>(vertices.size());
+		slots[slot] = index;
+		usedSlots++;
+		vertices.push_back(vertex);
+		return index;
+	}
+
+	//only reached when the caller underestimated maxVertices
+	void LveVertexWelder::grow(const std::vector<LveModel::Vertex>& vertices)
+	{
+		std::vector<uint32_t> oldSlots(slots.size() * 2, EMPTY_SLOT);
+		oldSlots.swap(slots);
+		slotMask = slots.size() - 1;
+
+		for (uint32_t index : oldSlots)
+		{
+			if (index == EMPTY_SLOT)
+			{
+				continue;
+			}
+
+			size_t slot = hashVertex(vertices[index]) & slotMask;
+			while (slots[slot] != EMPTY_SLOT)
+			{
+				slot = (slot + 1) & slotMask;
+			}
+			slots[slot] = index;
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "lve_model.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace lve
+{
+	// Flat open-addressing table used to weld identical vertices while importing a mesh.
+	// Slots only hold indices into the caller's vertex array, so a lookup and an insert share one probe sequence.
+	class LveVertexWelder
+	{
+	public:
+		//maxVertices is an upper bound on the unique vertices that will be welded (the index count works)
+		LveVertexWelder(size_t maxVertices);
+
+		LveVertexWelder(const LveVertexWelder&) = delete;
+		LveVertexWelder& operator=(const LveVertexWelder&) = delete;
+
+		//returns the index of an equal vertex already in vertices, or appends it and returns the new index
+		uint32_t weld(const LveModel::Vertex& vertex, std::vector<LveModel::Vertex>& vertices);
+
+		static uint32_t hashVertex(const LveModel::Vertex& vertex);
+
+	private:
+		void grow(const std::vector<LveModel::Vertex>& vertices);
+
+		static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+		std::vector<uint32_t> slots;
+		size_t slotMask = 0;
+		size_t usedSlots = 0;
+	};
+}
@@ -1,5 +1,7 @@
 #include "lve_window.hpp"
 
+#include <stb_image.h>
+
 #include <stdexcept>
 
 namespace lve
@@ -34,6 +36,14 @@ namespace lve
 		}
 	}
 
+	void LveWindow::setIcon(const std::string& filepath)
+	{
+		GLFWimage images[1];
+		images[0].pixels = stbi_load(filepath.c_str(), &images[0].width, &images[0].height, 0, 4); //rgba channels 
+		glfwSetWindowIcon(window, 1, images);
+		stbi_image_free(images[0].pixels);
+	}
+
 	void LveWindow::framebufferResizeCallback(GLFWwindow* window, int width, int height)
 	{
 		auto lveWindow = reinterpret_cast<LveWindow*>(glfwGetWindowUserPointer(window));
@@ -22,6 +22,7 @@ namespace lve
 		GLFWwindow *getGLFWwindow() const { return window; }
 
 		void createWindowSurface(VkInstance instance, VkSurfaceKHR *surface);
+		void setIcon(const std::string& filepath);
 
 	private:
 		static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
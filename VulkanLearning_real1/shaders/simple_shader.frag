@@ -8,7 +8,9 @@ layout (location = 3) in vec2 fragUv;
 
 layout (location = 0) out vec4 outColor;
 
-layout(binding = 1) uniform sampler2D texSampler;
+// LveTextureRegistry::getCapacity(), 64 unless the pipeline specializes it
+layout (constant_id = 0) const uint MAX_TEXTURES = 64;
+layout(set = 0, binding = 1) uniform sampler2D textures[MAX_TEXTURES];
 
 struct PointLight
 {
@@ -29,7 +31,7 @@ layout(set = 0, binding = 0) uniform GlobalUbo
 layout(push_constant) uniform Push
 {
 	mat4 modelMatrix;
-	mat4 normalMatrix;
+	mat4 normalMatrix; // [3][3] is the texture index
 } push;
 
 void main()
@@ -63,5 +65,5 @@ void main()
 	}
 	
 	//outColor = vec4(diffuseLight * fragColor + specularLight * fragColor, 1.0);
-	outColor = vec4(diffuseLight * fragColor + specularLight * fragColor, 0.0) + texture(texSampler, fragUv);
+	outColor = vec4(diffuseLight * fragColor + specularLight * fragColor, 0.0) + texture(textures[int(push.normalMatrix[3][3])], fragUv);
 }
\ No newline at end of file
@@ -112,7 +112,7 @@ namespace lve
 		lvePipeline->bind(frameInfo.commandBuffer);
 
 		vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
-			0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
+			0, 1, &frameInfo.globalDescriptorSet, 1, &frameInfo.globalUboOffset);
 		//iterate through sorted lights in reverse
 		for (auto it = sorted.rbegin(); it != sorted.rend(); ++it)
 		{
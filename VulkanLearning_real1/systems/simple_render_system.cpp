@@ -5,6 +5,7 @@
 #include <glm.hpp>
 #include <gtc/constants.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 #include <array>
 
@@ -14,10 +15,11 @@ namespace lve
 	struct SimplePushConstantData
 	{
 		glm::mat4 modelMatrix{ 1.f };
-		glm::mat4 normalMatrix{ 1.f };
+		glm::mat4 normalMatrix{ 1.f };	//only the upper 3x3 is the normal matrix, [3][3] carries the texture index
 	};
 
-	SimpleRenderSystem::SimpleRenderSystem(LveDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout) : lveDevice{device}
+	SimpleRenderSystem::SimpleRenderSystem(LveDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout,
+		uint32_t textureCapacity) : lveDevice{device}, renderPass{renderPass}, textureCapacity{textureCapacity}
 	{
 		createPipeLineLayout(globalSetLayout);
 		createPipeline(renderPass);
@@ -61,31 +63,101 @@ namespace lve
 		
 		pipelineConfig.renderPass = renderPass;
 		pipelineConfig.pipelineLayout = pipelineLayout;
+		pipelineConfig.fragmentConstants = { textureCapacity };
 		lvePipeline = std::make_unique<LvePipeline>(lveDevice, "shaders/simple_shader.vert.spv",
 			"shaders/simple_shader.frag.spv", pipelineConfig);
 
 	}
 
+	void SimpleRenderSystem::createPackedPipeline()
+	{
+		PipelineConfigInfo pipelineConfig{};
+		LvePipeline::defaultPipelineConfigInfo(pipelineConfig);
+		pipelineConfig.bindingDescriptions = LveModel::PackedVertex::getBindingDescriptions();
+		pipelineConfig.attributeDescriptions = LveModel::PackedVertex::getAttributeDescriptions();
+
+		pipelineConfig.renderPass = renderPass;
+		pipelineConfig.pipelineLayout = pipelineLayout;
+		pipelineConfig.fragmentConstants = { textureCapacity };
+		packedPipeline = std::make_unique<LvePipeline>(lveDevice, "shaders/simple_shader_packed.vert.spv",
+			"shaders/simple_shader.frag.spv", pipelineConfig);
+	}
+
 
 	void SimpleRenderSystem::renderGameObjects(FrameInfo &frameInfo)
 	{
-		lvePipeline->bind(frameInfo.commandBuffer);
-
+		//one pass per vertex format, both pipelines share the layout so the descriptor set stays bound
 		vkCmdBindDescriptorSets(frameInfo.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout,
-			0, 1, &frameInfo.globalDescriptorSet, 0, nullptr);
+			0, 1, &frameInfo.globalDescriptorSet, 1, &frameInfo.globalUboOffset);
+
+		//pooled models share the same buffers, so usually only the first object binds any geometry
+		LveModel::BindState bindState{};
+		renderGameObjects(frameInfo, VertexFormat::Full, bindState);
+		renderGameObjects(frameInfo, VertexFormat::Packed, bindState);
+	}
+
+	void SimpleRenderSystem::renderGameObjects(FrameInfo& frameInfo, VertexFormat vertexFormat, LveModel::BindState& bindState)
+	{
+		bool pipelineBound = false;
 
 		for (auto& kv : frameInfo.gameObjects)
 		{
 			auto& obj = kv.second;
-			if (obj.model == nullptr) continue;
+			if (obj.model == nullptr || obj.model->getVertexFormat() != vertexFormat) continue;
+
+			if (!pipelineBound)
+			{
+				if (vertexFormat == VertexFormat::Packed)
+				{
+					if (packedPipeline == nullptr) createPackedPipeline();
+					packedPipeline->bind(frameInfo.commandBuffer);
+				}
+				else
+				{
+					lvePipeline->bind(frameInfo.commandBuffer);
+				}
+				pipelineBound = true;
+			}
+
 			SimplePushConstantData push{};
-			push.modelMatrix = obj.transform.mat4();
+			push.modelMatrix = obj.transform.mat4() * obj.model->getDequantizeMatrix();
 			push.normalMatrix = obj.transform.normalMatrix();
+			//as a float, exact far past LveTextureRegistry::MAX_CAPACITY, and the push constants stay at 128 bytes
+			push.normalMatrix[3][3] = static_cast<float>(obj.textureIndex);
 
 			vkCmdPushConstants(frameInfo.commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 				0, sizeof(SimplePushConstantData), &push);
-			obj.model->bind(frameInfo.commandBuffer);
-			obj.model->draw(frameInfo.commandBuffer);
+			obj.model->bind(frameInfo.commandBuffer, bindState);
+			obj.model->draw(frameInfo.commandBuffer, selectLod(*obj.model, obj.transform, frameInfo.camera));
+		}
+	}
+
+	uint32_t SimpleRenderSystem::selectLod(const LveModel& model, TransformComponent& transform, const LveCamera& camera) const
+	{
+		const auto& lods = model.getLods();
+		if (lods.size() <= 1)
+		{
+			return 0;
+		}
+
+		float scale = std::max({ std::abs(transform.scale.x), std::abs(transform.scale.y), std::abs(transform.scale.z) });
+		glm::vec3 center{ transform.mat4() * glm::vec4{ model.getBoundsCenter(), 1.f } };
+		float distance = glm::length(center - camera.getPosition()) - model.getBoundsRadius() * scale;
+		if (distance <= 0.f)
+		{
+			return 0;
+		}
+
+		//projection[1][1] is 1 / tan(fovy / 2), so this maps a world size at that distance to half screen heights
+		float screenScale = camera.getProjection()[1][1] * scale / distance;
+
+		for (uint32_t lod = static_cast<uint32_t>(lods.size()) - 1; lod > 0; lod--)
+		{
+			if (lods[lod].error * screenScale <= maxLodScreenError)
+			{
+				return lod;
+			}
 		}
+		return 0;
 	}
 }
\ No newline at end of file
@@ -16,19 +16,33 @@ namespace lve
 	{
 	public:
 
-		SimpleRenderSystem(LveDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+		//textureCapacity is the size of the texture array in globalSetLayout, LveTextureRegistry::getCapacity()
+		SimpleRenderSystem(LveDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout,
+			uint32_t textureCapacity);
 		~SimpleRenderSystem();
 
 		SimpleRenderSystem(const SimpleRenderSystem&) = delete;
 		SimpleRenderSystem& operator=(const SimpleRenderSystem&) = delete;
 
 		void renderGameObjects(FrameInfo &frameInfo);
+
+		//coarsest LOD whose simplification error stays under this on screen, in units of half the screen height
+		//(.002 is about a pixel at 1080p)
+		float maxLodScreenError = .002f;
+
 	private:
+		uint32_t selectLod(const LveModel& model, TransformComponent& transform, const LveCamera& camera) const;
 		void createPipeLineLayout(VkDescriptorSetLayout globalSetLayout);
 		void createPipeline(VkRenderPass renderPass);
+		//built on first use, so scenes without packed models never load its shader
+		void createPackedPipeline();
+		void renderGameObjects(FrameInfo& frameInfo, VertexFormat vertexFormat, LveModel::BindState& bindState);
 
 		LveDevice& lveDevice;
+		VkRenderPass renderPass;
+		uint32_t textureCapacity;
 		std::unique_ptr<LvePipeline> lvePipeline;
+		std::unique_ptr<LvePipeline> packedPipeline;
 		VkPipelineLayout pipelineLayout;
 	};
 }
\ No newline at end of file